@@ -0,0 +1,43 @@
+/* Sidereal Planets Library - Long span timing
+ * Version 1.6.0 - May 24, 2025
+ * Example11_LongSpan
+*/
+
+#include <SiderealPlanets.h>
+
+// Need the following define for SAMD processors
+#if defined(ARDUINO_SAMD_ZERO) && defined(SERIAL_PORT_USBVIRTUAL)
+#define Serial SERIAL_PORT_USBVIRTUAL
+#endif
+
+SiderealPlanets myAstro;
+
+void setup() {
+  Serial.begin(9600);
+  delay(2000); //SAMD boards may need a long time to init SerialUSB
+  Serial.println("Sidereal Planets Timing Over 8000 Years\n");
+  myAstro.begin();
+  myAstro.setLatLong(40.0, -75.0);
+  Serial.println("Microseconds per doBody() call, every 1000 years from -4000 to +4000");
+  Serial.println("Year   Sun Mercury Venus Mars Jupiter Saturn Uranus Neptune Moon");
+  for (int year = -4000; year <= 4000; year += 1000) {
+    // Days since 1900 January 0.5, near the start of the year
+    double epoch = (year - 1900) * 365.25;
+    Serial.print(year);
+    for (int body = SP_SUN; body <= SP_MOON; body++) {
+      unsigned long start = micros();
+      for (int i = 0; i < 10; i++) {
+        myAstro.setGMTepoch(epoch + (i * 1.37));
+        myAstro.doBody(body);
+      }
+      Serial.print(" ");
+      Serial.print((micros() - start) / 10.0, 1);
+    }
+    Serial.println();
+  }
+  Serial.println("\nAngles are reduced with fmod(), so each column should stay about");
+  Serial.println("the same from one end of the span to the other.");
+}
+
+void loop() {
+}
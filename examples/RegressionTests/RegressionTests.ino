@@ -7,6 +7,19 @@
 */
 
 #include <SiderealPlanets.h>
+#include <SiderealRefraction.h>
+#include <SiderealSolarField.h>
+#include <SiderealHorizon.h>
+#include <SiderealAirmass.h>
+#include <SiderealTask.h>
+#include <SiderealScheduler.h>
+#include <SiderealVisibility.h>
+#include <SiderealEvents.h>
+#include <SiderealSkyState.h>
+#include <SiderealCache.h>
+#include <SiderealTimeZone.h>
+#include <SiderealEphemeris.h>
+#include <SiderealMinorBodies.h>
 
 // Need the following define for SAMD processors
 #if defined(ARDUINO_SAMD_ZERO) && defined(SERIAL_PORT_USBVIRTUAL)
@@ -21,6 +34,9 @@ void setup() {
   Serial.println("Sidereal Planets Regression Tests");
 
   myAstro.begin();
+  Serial.println("\nMemory used by one SiderealPlanets object (was 1640 bytes with 8 byte doubles)");
+  Serial.println("sizeof(SiderealPlanets) = 976 with 8 byte doubles, 504 with 4 byte doubles");
+  Serial.println(sizeof(SiderealPlanets));
   Serial.println("\nCompute decimal degrees from DMS input");
   Serial.println("degrees 238 min 55 sec 10.02 = 238.91945");
   Serial.println(myAstro.decimalDegrees(238, 55, 10.02), 6);
@@ -49,6 +65,26 @@ void setup() {
   Serial.print("Julian Date = ");
   Serial.println(myAstro.modifiedJulianDate1900()+2415020.0+0.5);
   
+  Serial.println("Epoch for 3/1/2025 0h GMT from Unix time 1740787200, JD 2460735.5 and MJD 60735 = 45715.5000");
+  myAstro.setUnixTime(1740787200LL);
+  Serial.println(myAstro.getGMTepoch(), 4);
+  myAstro.setJulianDate(2460735L, 0.5);
+  Serial.println(myAstro.getGMTepoch(), 4);
+  myAstro.setMJD(60735L, 0.0);
+  Serial.println(myAstro.getGMTepoch(), 4);
+  
+  Serial.println("Compile-time helpers: mjd1900 for 2/2/1989 = 32539.50, 5/24/2025 is a Saturday = 6");
+  Serial.println("GST for Mar 11, 1990 UT=17:21:43.7 = 4:38:9.22, the same as getGMTsiderealTime() below");
+  {
+    constexpr double day = siderealMJD1900(1989, 2, 2);
+    constexpr int weekday = siderealDayOfWeek(2025, 5, 24);
+    constexpr double gst = siderealGMST(siderealMJD1900(1990, 3, 11), 1990, 17.0 + (21.0 / 60.0) + (43.7 / 3600.0));
+    Serial.println(day);
+    Serial.println(weekday);
+    myAstro.printDegMinSecs(gst);
+    Serial.println("\n");
+  }
+  
   Serial.println("\nCompute Sidereal Times");
   Serial.println("DST on, Time Zone = -10, Long = -148d 31 min 52.33 sec");
   Serial.println("Date: Mar 11, 1990  Local Time: 8:21:43.7");
@@ -117,6 +153,57 @@ void setup() {
   myAstro.printDegMinSecs(myAstro.getDeclinationDec());
   Serial.println("\n");
   
+  Serial.println("Sky grid, one cell at the same RA/Dec: Az=119:18:14.59 Alt=0:16:15.88 to float precision");
+  {
+    float altitude, azimuth;
+    myAstro.doSkyGrid(myAstro.decimalDegrees(20,40,5.2), 0.1, 1, myAstro.decimalDegrees(-22,12,0), 1.0, 1, &altitude, &azimuth);
+    myAstro.printDegMinSecs(azimuth);
+    myAstro.printDegMinSecs(altitude);
+    Serial.println("\n");
+  }
+  
+  Serial.println("Sky grid through the zenith at 40 sites, 3/1/2025: NaN cells = 0, highest = 90:0:0.00");
+  {
+    SiderealPlanets zenith;
+    zenith.begin();
+    zenith.setGMTdate(2025, 3, 1);
+    float altitude[25], azimuth[25];
+    int nanCells = 0;
+    float highest = -90.0;
+    for (int site = 0; site < 40; site++) {
+      zenith.setLatLong(-89.9 + (site * 0.0899), -75.0 + (site * 0.01));
+      zenith.setGMTtime(site % 24, site, 0.0);
+      zenith.doSkyGrid(zenith.getLocalSiderealTime(), 24.0 / 25.0, 25, zenith.getLatitude(), 1.0, 1, altitude, azimuth);
+      for (int i = 0; i < 25; i++) {
+        if (isnan(altitude[i])) nanCells++;
+        else if (altitude[i] > highest) highest = altitude[i];
+      }
+    }
+    Serial.print("NaN cells = ");
+    Serial.print(nanCells);
+    Serial.print(", highest = ");
+    myAstro.printDegMinSecs(highest);
+    Serial.println("\n");
+  }
+  
+  Serial.println("Batch Alt/Az and direction vector to RA/Dec: both 20:40:5.2 -22:12:0.0 to float precision");
+  {
+    float altitude = myAstro.decimalDegrees(0,16,15.88);
+    float azimuth = myAstro.decimalDegrees(119,18,14.59);
+    float east = cos(altitude * 1.745329252e-2) * sin(azimuth * 1.745329252e-2);
+    float north = cos(altitude * 1.745329252e-2) * cos(azimuth * 1.745329252e-2);
+    float up = sin(altitude * 1.745329252e-2);
+    float rightAscension, declination;
+    myAstro.doAltAz2RAdec(&altitude, &azimuth, 1, &rightAscension, &declination);
+    myAstro.printDegMinSecs(rightAscension);
+    myAstro.printDegMinSecs(declination);
+    Serial.println();
+    myAstro.doVector2RAdec(&east, &north, &up, 1, &rightAscension, &declination);
+    myAstro.printDegMinSecs(rightAscension);
+    myAstro.printDegMinSecs(declination);
+    Serial.println("\n");
+  }
+  
   Serial.println("Precess from 1/0.9/1950 to 2/4/1990");
   Serial.println("Input RA = 12 hr 12 min 12 sec, Dec = 23d 23 min 23 sec");
   Serial.println("Output RA = 12 hr 14 min 13.93 sec, Dec = 23d 10 min 0.64 sec");
@@ -237,6 +324,71 @@ void setup() {
   myAstro.printDegMinSecs(myAstro.getDeclinationDec());
   Serial.println("\n");
   
+  Serial.println("Refraction table, same altitude, pressure and temperature");
+  Serial.println("Should match doRefractionC() to 1 arc second");
+  {
+    myAstro.setRAdec(myAstro.decimalDegrees(23,14,0.0), myAstro.decimalDegrees(40,10,0.0));
+    myAstro.doRAdec2AltAz();
+    double altitude = myAstro.getAltitude();
+    myAstro.doRefractionC(1012., 21.7);
+    SiderealRefraction refraction;
+    refraction.begin();
+    refraction.setWeatherC(1012., 21.7);
+    double corrected;
+    refraction.doRefraction(&altitude, &corrected, 1);
+    Serial.print("doRefractionC() Altitude: ");
+    myAstro.printDegMinSecs(myAstro.getAltitude());
+    Serial.println();
+    Serial.print("Table Altitude:           ");
+    myAstro.printDegMinSecs(corrected);
+    Serial.println();
+    myAstro.setRAdec(myAstro.decimalDegrees(23,14,0.0), myAstro.decimalDegrees(40,10,0.0));
+    myAstro.doRAdec2AltAz();
+    myAstro.doRefractionC(1010., 10.);
+    SiderealRefraction unbuilt;
+    unbuilt.begin();
+    Serial.print("doRefractionC(1010, 10):  ");
+    myAstro.printDegMinSecs(myAstro.getAltitude());
+    Serial.println();
+    Serial.print("No table, default:        ");
+    myAstro.printDegMinSecs(altitude + unbuilt.getRefraction(altitude));
+    Serial.println("\n");
+  }
+  
+  Serial.println("Airmass at 90, 30 and 0 degrees (Kasten and Young) = 0.9997 1.9943 37.92");
+  Serial.print(SiderealAirmass::calcAirmass(90.0), 4);
+  Serial.print(" ");
+  Serial.print(SiderealAirmass::calcAirmass(30.0), 4);
+  Serial.print(" ");
+  Serial.println(SiderealAirmass::calcAirmass(0.0), 2);
+  Serial.println("Airmass curve, same target and time: should match calcAirmass() of the doRefractionC() altitude");
+  {
+    SiderealAirmass airmass;
+    airmass.begin(myAstro.decimalDegrees(51,12,13), myAstro.decimalDegrees(0,10,12.0));
+    airmass.setWeatherC(1012., 21.7);
+    double rightAscension = myAstro.decimalDegrees(23,14,0.0);
+    double declination = myAstro.decimalDegrees(40,10,0.0);
+    airmass.setTargets(&rightAscension, &declination, 1);
+    float curve;
+    airmass.doCurves(myAstro.getGMTepoch(), 5.0, 1, &curve);
+    myAstro.setRAdec(rightAscension, declination);
+    myAstro.doRAdec2AltAz();
+    myAstro.doRefractionC(1012., 21.7);
+    Serial.print("calcAirmass(): ");
+    Serial.println(SiderealAirmass::calcAirmass(myAstro.getAltitude()), 4);
+    Serial.print("doCurves():    ");
+    Serial.println(curve, 4);
+    Serial.println("Dec -80 never rises here; with no extinction, airmass and extinction are infinite = 1 1");
+    declination = -80.0;
+    float magnitudes;
+    airmass.setExtinction(0.0);
+    airmass.doCurves(myAstro.getGMTepoch(), 5.0, 1, &curve, &magnitudes);
+    Serial.print(isinf(curve));
+    Serial.print(" ");
+    Serial.println(isinf(magnitudes));
+    Serial.println();
+  }
+  
   Serial.println("Mean Anomaly = 220d 23m 10s; Eccentricity = 0.0167183");
   Serial.println("Eccentric Anomaly = 219d 46m 23.76s; True Anomaly = -140d 50m 8.41s");
   myAstro.printDegMinSecs(myAstro.doAnomaly(myAstro.decimalDegrees(220,23,10.0), 0.0167183));
@@ -440,6 +592,15 @@ void setup() {
   myAstro.printDegMinSecs(myAstro.getDeclinationDec());
   Serial.println("\n");
   
+  Serial.println("Neptune: Date: Jan 1, -4000, 0h GMT, angles thousands of revolutions from 1900");
+  Serial.println("RA: 4:56:42.50, Dec: 23:36:56.20 (as the old step-by-step angle reduction gave)");
+  myAstro.setGMTdate(-4000,1,1);
+  myAstro.setGMTtime(0,0,0.0);
+  myAstro.doBody(SP_NEPTUNE);
+  myAstro.printDegMinSecs(myAstro.getRAdec());
+  myAstro.printDegMinSecs(myAstro.getDeclinationDec());
+  Serial.println("\n");
+  
   Serial.println("Moon: no DST, Time Zone = 0, LT = 0, Date: Feb 25,1984");
   myAstro.setTimeZone(0);
   myAstro.rejectDST();
@@ -469,6 +630,18 @@ void setup() {
   }
   Serial.println("\n");
   
+  Serial.println("Moon lighting in one pass, same date: RA 17:19:20.65, Dec -23:52:22.51, 37 percent, phase 7");
+  {
+    SiderealMoonPhase moon;
+    myAstro.doSunMoon(moon);
+    myAstro.printDegMinSecs(moon.rightAscension);
+    myAstro.printDegMinSecs(moon.declination);
+    Serial.print(moon.illumination * 100.0);
+    Serial.print(" ");
+    Serial.println(moon.phase);
+    Serial.println();
+  }
+  
   Serial.println("Moon: DST, Time Zone = 6, LT = 11:42:20, Date: Aug 14, 1989");
   myAstro.setTimeZone(6);
   myAstro.setDST();
@@ -502,6 +675,36 @@ void setup() {
   myAstro.printDegMinSecs(myAstro.getEquatHorizontalParallax());
   Serial.println("\n");
   
+  Serial.println("Accuracy tiers, Moon (8) and Mars (3): 2/26/1979 16:45:00 GMT");
+  Serial.println("RA/Dec, then distance from SP_ACCURACY_FULL in arc seconds for tiers 0, 1 and 2");
+  Serial.println("Should be under Moon 24 and 390, Mars 42 and 366, the largest differences over 1900 to 2000");
+  {
+    int tierBodies[2] = {SP_MOON, SP_MARS};
+    for (int b = 0; b < 2; b++) {
+      double fullRA = 0.0, fullDec = 0.0;
+      for (int tier = SP_ACCURACY_FULL; tier <= SP_ACCURACY_DEGREE; tier++) {
+        myAstro.setAccuracy(tier);
+        myAstro.doBody(tierBodies[b]);
+        if (tier == SP_ACCURACY_FULL) {
+          fullRA = myAstro.getRAdec();
+          fullDec = myAstro.getDeclinationDec();
+        }
+        double dRA = (myAstro.getRAdec() - fullRA) * 15.0 * cos(fullDec / 57.29577951);
+        double dDec = myAstro.getDeclinationDec() - fullDec;
+        Serial.print(tierBodies[b]);
+        Serial.print(" ");
+        Serial.print(tier);
+        Serial.print(" RA/Dec: ");
+        myAstro.printDegMinSecs(myAstro.getRAdec());
+        myAstro.printDegMinSecs(myAstro.getDeclinationDec());
+        Serial.print(" ");
+        Serial.println(sqrt((dRA * dRA) + (dDec * dDec)) * 3600.0, 1);
+      }
+    }
+    myAstro.setAccuracy(SP_ACCURACY_FULL);
+    Serial.println();
+  }
+  
   Serial.println("Moon Rise/Set: no DST, Time Zone = 0,  Date: Jan 7,1984");
   Serial.println("Geo Long: 0:0:0.0, Lat: 30:0:0.0");
   Serial.println("local Rise=9:58:1.46 local Set=21:8:59.44");
@@ -537,6 +740,441 @@ void setup() {
   myAstro.printDegMinSecs(myAstro.getMoonriseTime());
   myAstro.printDegMinSecs(myAstro.getMoonsetTime());
   Serial.println("\n");
+  
+  Serial.println("Heliostat field, Sun: 2/26/1979 16:45:00 GMT, Lat 50, Long -100, Elevation 60m, 1010 mb, 10 C");
+  Serial.println("Sun Alt/Az should match doSun(), doTopocentric(), doRAdec2AltAz() and doRefractionC()");
+  Serial.println("A mirror aimed straight up should face the same azimuth at (90 + Sun altitude) / 2");
+  {
+    SiderealSolarField field;
+    field.begin(50.0, -100.0, 60.0);
+    double east = 0.0, north = 0.0, up = 0.0;
+    field.setHeliostats(&east, &north, &up, 1);
+    field.setTarget(0.0, 0.0, 100.0);
+    myAstro.setLatLong(50.0, -100.0);
+    myAstro.setElevationM(60.0);
+    myAstro.setGMTdate(1979, 2, 26);
+    myAstro.setGMTtime(16, 45, 0.0);
+    double normalEast, normalNorth, normalUp;
+    double epoch = myAstro.getGMTepoch();
+    field.doTick(epoch, &normalEast, &normalNorth, &normalUp);
+    myAstro.doBody(SP_SUN);
+    SiderealPosition sun = {myAstro.getRAdec(), myAstro.getDeclinationDec(), 0.0, 0.0, myAstro.getBodyDistance()};
+    myAstro.doTopocentric(&epoch, &sun, 1);
+    myAstro.setRAdec(sun.rightAscension, sun.declination);
+    myAstro.doRAdec2AltAz();
+    myAstro.doRefractionC(1010., 10.);
+    Serial.print("Scalar Sun Alt/Az: ");
+    myAstro.printDegMinSecs(myAstro.getAltitude());
+    myAstro.printDegMinSecs(myAstro.getAzimuth());
+    Serial.println();
+    Serial.print("Field Sun Alt/Az:  ");
+    myAstro.printDegMinSecs(field.getSunAltitude());
+    myAstro.printDegMinSecs(field.getSunAzimuth());
+    Serial.println();
+    Serial.print("Mirror Alt/Az:     ");
+    myAstro.printDegMinSecs(asin(normalUp) * 57.29577951);
+    myAstro.printDegMinSecs(atan2(normalEast, normalNorth) * 57.29577951);
+    Serial.println("\n");
+  }
+  
+  Serial.println("Moving observer track, Moon: 2/26/1979 16:45:00 GMT, Lat 50, Long -100, Elevation 60m");
+  Serial.println("Should match the scalar Alt/Az, 24:57:52.26 144:42:56.09, to about 0.05 arc seconds");
+  {
+    myAstro.setGMTdate(1979, 2, 26);
+    myAstro.setGMTtime(16, 45, 0.0);
+    double epoch = myAstro.getGMTepoch();
+    double latitude = 50.0, longitude = -100.0, elevation = 60.0;
+    double altitude, azimuth;
+    myAstro.doTrack(SP_MOON, &epoch, &latitude, &longitude, &elevation, 1, &altitude, &azimuth);
+    myAstro.printDegMinSecs(altitude);
+    myAstro.printDegMinSecs(azimuth);
+    Serial.println("\n");
+  }
+  
+  Serial.println("Horizon mask, RA 10:8:22.2 Dec 11:58:1.9, 3/1/2025 GMT, Lat 40, Long -75");
+  Serial.println("Flat mask should match doRiseSetTimes(0), and a 5 degree mask doRiseSetTimes(-5), to about 1 second");
+  {
+    SiderealHorizon horizon;
+    horizon.begin(40.0, -75.0, 0.0);
+    myAstro.setLatLong(40.0, -75.0);
+    myAstro.setTimeZone(0);
+    myAstro.rejectDST();
+    myAstro.setGMTdate(2025, 3, 1);
+    double march1 = myAstro.modifiedJulianDate1900();
+    float mask[4] = {5.0, 5.0, 5.0, 5.0};
+    for (int m = 0; m < 2; m++) {
+      horizon.setMask(mask, (m == 0) ? 0 : 4);
+      horizon.doRiseSet(10.1395, 11.9672, march1, march1 + 1.0, 0.0);
+      myAstro.setRAdec(10.1395, 11.9672);
+      myAstro.doRiseSetTimes((m == 0) ? 0.0 : -5.0);
+      Serial.print("doRiseSetTimes() Rise/Set: ");
+      myAstro.printDegMinSecs(myAstro.getRiseTime());
+      myAstro.printDegMinSecs(myAstro.getSetTime());
+      Serial.println();
+      Serial.print("Mask Events:               ");
+      for (int k = 0; k < horizon.getEventCount(); k++) {
+        Serial.print(horizon.getEventRising(k) ? "Rise " : "Set ");
+        myAstro.printDegMinSecs((horizon.getEventTime(k) - march1) * 24.0);
+      }
+      Serial.println();
+    }
+    Serial.println("Valley mask N..NW 3 6 14 9 2 4 10 1 should match a one second brute force sweep");
+    Serial.println("Brute force Events:        Set 10:27:17.91 Rise 22:57:22.05");
+    float valley[8] = {3.0, 6.0, 14.0, 9.0, 2.0, 4.0, 10.0, 1.0};
+    horizon.setMask(valley, 8);
+    horizon.doRiseSet(10.1395, 11.9672, march1, march1 + 1.0, 0.0);
+    Serial.print("Mask Events:               ");
+    for (int k = 0; k < horizon.getEventCount(); k++) {
+      Serial.print(horizon.getEventRising(k) ? "Rise " : "Set ");
+      myAstro.printDegMinSecs((horizon.getEventTime(k) - march1) * 24.0);
+    }
+    Serial.println("\n");
+  }
+  
+  Serial.println("Time-sliced Moon Rise/Set: no DST, Time Zone = 0,  Date: Jan 7,1984, Lat 30, Long 0");
+  Serial.println("1 microsecond slices, one doMoon() step each: 7 slices, found 1, and the times of doMoonRiseSetTimes() above");
+  {
+    myAstro.rejectDST();
+    myAstro.setTimeZone(0);
+    myAstro.setLatLong(30.0, 0.0);
+    myAstro.setGMTdate(1984, 1, 7);
+    SiderealTask task;
+    task.begin(myAstro);
+    task.startRiseSet(SP_MOON);
+    int slices = 0;
+    while (task.doSlice(1) == false) slices++;
+    Serial.print("Slices: ");
+    Serial.print(slices + 1);
+    Serial.print(", found ");
+    Serial.println(task.getFound());
+    myAstro.printDegMinSecs(myAstro.getMoonriseTime());
+    myAstro.printDegMinSecs(myAstro.getMoonsetTime());
+    Serial.println("\n");
+  }
+  
+  Serial.println("Time-sliced Mars position, same date and site, 1 microsecond slices");
+  Serial.println("One stage each: Sun, 2 light time passes, apparent position = 4 slices, and the RA/Dec of doBody(SP_MARS)");
+  {
+    int body = SP_MARS;
+    SiderealPosition position;
+    SiderealTask task;
+    task.begin(myAstro);
+    task.startPositions(&body, 1, &position);
+    int slices = 0;
+    while (task.doSlice(1) == false) slices++;
+    Serial.print("Slices: ");
+    Serial.println(slices + 1);
+    myAstro.doBody(SP_MARS);
+    Serial.print("doBody RA/Dec: ");
+    myAstro.printDegMinSecs(myAstro.getRAdec());
+    myAstro.printDegMinSecs(myAstro.getDeclinationDec());
+    Serial.println();
+    Serial.print("Task RA/Dec:   ");
+    myAstro.printDegMinSecs(position.rightAscension);
+    myAstro.printDegMinSecs(position.declination);
+    Serial.println("\n");
+  }
+  
+  Serial.println("Mars from J2000 mean elements: 1/1/2000 12:00:00 GMT");
+  Serial.println("a 1.52371034 e 0.09339410 i 1.84969142 node 49.55953891 peri 286.49683150 M 19.39019754");
+  Serial.println("Should match doBody(SP_MARS) to about 0.005 degrees");
+  {
+    myAstro.setGMTdate(2000, 1, 1);
+    myAstro.setGMTtime(12, 0, 0.0);
+    SiderealOrbit orbit;
+    SiderealOrbitConstants constants;
+    SiderealPosition position;
+    SiderealMinorBodies::calcOrbitFromMeanAnomaly(myAstro.getGMTepoch(), 19.39019754, 1.52371034, 0.09339410,
+      1.84969142, 49.55953891, 286.49683150, orbit);
+    SiderealMinorBodies::calcOrbitConstants(orbit, constants);
+    SiderealMinorBodies minor;
+    minor.begin(myAstro);
+    minor.doPositions(&constants, 1, &position);
+    myAstro.doBody(SP_MARS);
+    Serial.print("doBody RA/Dec:   ");
+    myAstro.printDegMinSecs(myAstro.getRAdec());
+    myAstro.printDegMinSecs(myAstro.getDeclinationDec());
+    Serial.println();
+    Serial.print("Elements RA/Dec: ");
+    myAstro.printDegMinSecs(position.rightAscension);
+    myAstro.printDegMinSecs(position.declination);
+    Serial.println("\n");
+
+    Serial.println("Comet near e = 1: q 0.5 AU, i 40, node 100, peri 200, perihelion 30 days after 1/1/2000");
+    Serial.println("e = 0.999999, 1 and 1.000001 should give the same RA/Dec");
+    double eccentricity[3] = {0.999999, 1.0, 1.000001};
+    for (int i = 0; i < 3; i++) {
+      SiderealOrbit comet = {myAstro.getGMTepoch() + 30.0, 0.5, eccentricity[i], 40.0, 100.0, 200.0};
+      SiderealMinorBodies::calcOrbitConstants(comet, constants);
+      minor.doPositions(&constants, 1, &position);
+      Serial.print("e = ");
+      Serial.print(eccentricity[i], 6);
+      Serial.print(" RA/Dec: ");
+      myAstro.printDegMinSecs(position.rightAscension);
+      myAstro.printDegMinSecs(position.declination);
+      Serial.println();
+    }
+    Serial.println();
+  }
+  
+#ifdef SIDEREAL_PLANETS_THREADS
+  Serial.println("Scheduler grid, Moon: 2/26/1979 16:45:00 GMT, Lat 50, Long -100, Elevation 60m");
+  Serial.println("Grid cell should match doMoon(), doLunarParallax() and doRAdec2AltAz()");
+  Serial.println("Items before begin() and after the run: 0 1");
+  {
+    SiderealEpoch epoch = {1979, 2, 26, 16, 45, 0.0};
+    SiderealSite site = {50.0, -100.0, 60.0};
+    int body = SP_MOON;
+    SiderealGrid grid = {&epoch, 1, &site, 1, &body, 1};
+    SiderealPosition cell;
+    SiderealScheduler scheduler;
+    Serial.print("Items: ");
+    Serial.print(scheduler.getWorkerStats(0).items);
+    scheduler.begin(2);
+    scheduler.runGrid(grid, &cell);
+    Serial.print(" ");
+    Serial.println(scheduler.getWorkerStats(0).items + scheduler.getWorkerStats(1).items);
+    myAstro.setLatLong(50.0, -100.0);
+    myAstro.setElevationM(60.0);
+    myAstro.setGMTdate(1979, 2, 26);
+    myAstro.setGMTtime(16, 45, 0.0);
+    myAstro.doMoon();
+    myAstro.doLunarParallax();
+    myAstro.doRAdec2AltAz();
+    Serial.print("Scalar Alt/Az: ");
+    myAstro.printDegMinSecs(myAstro.getAltitude());
+    myAstro.printDegMinSecs(myAstro.getAzimuth());
+    Serial.println();
+    Serial.print("Grid Alt/Az:   ");
+    myAstro.printDegMinSecs(cell.altitude);
+    myAstro.printDegMinSecs(cell.azimuth);
+    Serial.println("\n");
+  }
+#endif
+  
+#ifdef SIDEREAL_PLANETS_THREADS
+  Serial.println("Visibility window, RA 10:8:22.2 Dec 11:58:1.9 above 0 degrees, night of 3/1/2025 GMT");
+  Serial.println("Lat 40, Long -75, no twilight limit: should run from the 3/1 rise to the 3/2 set of doRiseSetTimes(), to about 1 second");
+  {
+    SiderealVisibility visibility;
+    visibility.begin(2);
+    visibility.setSite(40.0, -75.0, 0.0);
+    visibility.setTwilight(-90.0);
+    SiderealTarget target = {SP_FIXED, 10.1395, 11.9672, 0.0};
+    visibility.setTargets(&target, 1);
+    visibility.doNights(2025, 3, 1, 1);
+    myAstro.setLatLong(40.0, -75.0);
+    myAstro.setTimeZone(0);
+    myAstro.rejectDST();
+    myAstro.setRAdec(10.1395, 11.9672);
+    myAstro.setGMTdate(2025, 3, 1);
+    double march1 = myAstro.modifiedJulianDate1900();
+    myAstro.doRiseSetTimes(0.0);
+    Serial.print("doRiseSetTimes() Rise/Set: ");
+    myAstro.printDegMinSecs(myAstro.getRiseTime());
+    myAstro.setGMTdate(2025, 3, 2);
+    myAstro.doRiseSetTimes(0.0);
+    myAstro.printDegMinSecs(myAstro.getSetTime());
+    Serial.println();
+    SiderealWindow window = visibility.getWindow(0, 0, 0);
+    Serial.print("Window Start/End:          ");
+    myAstro.printDegMinSecs((window.start - march1) * 24.0);
+    myAstro.printDegMinSecs((window.end - march1 - 1.0) * 24.0);
+    Serial.println("\n");
+  }
+#endif
+  
+#ifdef SIDEREAL_PLANETS_HOST
+  Serial.println("Position cache, Moon: 2/26/1979 16:45:00 GMT, Lat 50, Long -100, Elevation 60m");
+  Serial.println("Miss and hit should both match the scalar Alt/Az above, with 1 hit and 1 miss");
+  {
+    SiderealEpoch epoch = {1979, 2, 26, 16, 45, 0.0};
+    SiderealSite site = {50.0, -100.0, 60.0};
+    SiderealPosition miss, hit;
+    SiderealCache cache;
+    cache.begin(16, 60.);
+    cache.getPosition(SP_MOON, epoch, site, miss);
+    cache.getPosition(SP_MOON, epoch, site, hit);
+    Serial.print("Miss Alt/Az: ");
+    myAstro.printDegMinSecs(miss.altitude);
+    myAstro.printDegMinSecs(miss.azimuth);
+    Serial.println();
+    Serial.print("Hit Alt/Az:  ");
+    myAstro.printDegMinSecs(hit.altitude);
+    myAstro.printDegMinSecs(hit.azimuth);
+    Serial.println();
+    Serial.print("Hits, misses: ");
+    Serial.print(cache.getHits());
+    Serial.print(" ");
+    Serial.println(cache.getMisses());
+    Serial.println();
+  }
+#endif
+  
+  Serial.println("Auto DST with a rule that has gone out of scope: Time Zone = 1, EU dates, 30 minutes");
+  Serial.println("1/15/2025 and 7/1/2025 12:00:00 GMT: DST 0 then 1, LT = 13:0:0.00 then 13:30:0.00");
+  {
+    myAstro.setTimeZone(1);
+    myAstro.setGMTdate(2025, 1, 15);
+    myAstro.setGMTtime(12, 0, 0.0);
+    {
+      SiderealDSTRule rule = SP_DST_EU;
+      rule.amount = 0.5;
+      Serial.print(myAstro.useAutoDST(rule));
+      Serial.print(" ");
+    }
+    myAstro.printDegMinSecs(myAstro.getLT());
+    myAstro.setGMTdate(2025, 7, 1);
+    myAstro.setGMTtime(12, 0, 0.0);
+    Serial.print(myAstro.useAutoDST());
+    Serial.print(" ");
+    myAstro.printDegMinSecs(myAstro.getLT());
+    Serial.println("\n");
+    myAstro.rejectDST();
+    myAstro.setTimeZone(0);
+  }
+  
+#ifdef SIDEREAL_PLANETS_HOST
+  Serial.println("Time zone table, Time Zone = -5, US DST rule, 2025");
+  Serial.println("2 transitions, 3/9 at 7.0000 GMT and 11/2 at 6.0000 GMT; offsets on 7/1 and 12/1 = -4.00 -5.00");
+  {
+    SiderealTimeZone timeZone;
+    timeZone.begin(-5, SP_DST_US, 2025, 2025);
+    myAstro.setGMTdate(2025, 3, 9);
+    double start = myAstro.modifiedJulianDate1900();
+    myAstro.setGMTdate(2025, 11, 2);
+    double end = myAstro.modifiedJulianDate1900();
+    Serial.print("Transitions: ");
+    Serial.print(timeZone.getTransitionCount());
+    Serial.print(" ");
+    Serial.print((timeZone.getTransition(0) - start) * 24.0, 4);
+    Serial.print(" ");
+    Serial.println((timeZone.getTransition(1) - end) * 24.0, 4);
+    myAstro.setGMTdate(2025, 7, 1);
+    Serial.print("Offsets: ");
+    Serial.print(timeZone.getOffset(myAstro.modifiedJulianDate1900()));
+    Serial.print(" ");
+    myAstro.setGMTdate(2025, 12, 1);
+    Serial.println(timeZone.getOffset(myAstro.modifiedJulianDate1900()));
+    Serial.println();
+  }
+#endif
+  
+#ifdef SIDEREAL_PLANETS_THREADS
+  Serial.println("Eclipses of 2025, type (0 solar partial, 5 lunar total) and GMT of minimum separation");
+  Serial.println("Greatest eclipse: 3/14 5 6:58:43, 3/29 0 10:47:27, 9/7 5 18:11:48, 9/21 0 19:41:59 (within a few minutes)");
+  {
+    SiderealEvents events;
+    events.begin(2);
+    myAstro.setGMTdate(2025, 1, 1);
+    myAstro.setGMTtime(0, 0, 0.0);
+    double start = myAstro.getGMTepoch();
+    myAstro.setGMTdate(2026, 1, 1);
+    events.doEclipses(start, myAstro.getGMTepoch());
+    Serial.print("Eclipses: ");
+    Serial.println(events.getEventCount());
+    for (int k = 0; k < events.getEventCount(); k++) {
+      SiderealEvent event = events.getEvent(k);
+      myAstro.setGMTepoch(event.epoch);
+      Serial.print(event.type);
+      Serial.print(" ");
+      myAstro.printDegMinSecs(myAstro.getGMT());
+      Serial.println();
+    }
+    Serial.println();
+  }
+#endif
+  
+#ifdef SIDEREAL_PLANETS_THREADS
+  Serial.println("Venus (2) and Mars (3) events, 1/1/2025 to 4/1/2025: type, body, days after 1/1/2025 0h GMT");
+  Serial.println("Published: 10 2 9.2 (greatest east), 9 3 15.1 (opposition), 13 3 54.1 and 12 2 60.0 (stations), 8 2 81.0 (inferior conjunction)");
+  {
+    SiderealEvents events;
+    events.begin(2);
+    int bodies[2] = {SP_VENUS, SP_MARS};
+    myAstro.setGMTdate(2025, 1, 1);
+    myAstro.setGMTtime(0, 0, 0.0);
+    double start = myAstro.getGMTepoch();
+    myAstro.setGMTdate(2025, 4, 1);
+    events.doPlanetEvents(start, myAstro.getGMTepoch(), bodies, 2);
+    for (int k = 0; k < events.getEventCount(); k++) {
+      SiderealEvent event = events.getEvent(k);
+      Serial.print(event.type);
+      Serial.print(" ");
+      Serial.print(event.body);
+      Serial.print(" ");
+      Serial.println(event.epoch - start, 3);
+    }
+    Serial.println();
+  }
+#endif
+  
+#ifdef SIDEREAL_PLANETS_HOST
+  Serial.println("Ephemeris file round trip, Moon: 2/26/1979 16:45:00 GMT and 1 and 2 hours later");
+  Serial.println("Lat 50, Long -100, Elevation 60m: 3 rows, epochs 28911.1979 28911.2396 28911.2812");
+  Serial.println("Row 0 Alt/Az should match the scalar Alt/Az above, 24:57:52.26 144:42:56.09");
+  {
+    SiderealSite site = {50.0, -100.0, 60.0};
+    int body = SP_MOON;
+    myAstro.setGMTdate(1979, 2, 26);
+    myAstro.setGMTtime(16, 45, 0.0);
+    double epochs[3];
+    for (int i = 0; i < 3; i++) epochs[i] = myAstro.getGMTepoch() + (i / 24.0);
+    SiderealEphemerisWriter writer;
+    writer.begin("RegressionTests.eph", site, &body, 1, 3);
+    writer.doRows(epochs, 3);
+    writer.end();
+    SiderealEphemerisReader reader;
+    Serial.print("Read: ");
+    Serial.print(reader.begin("RegressionTests.eph"));
+    Serial.print(", rows: ");
+    Serial.println((long)reader.getRowCount());
+    SiderealColumn epoch = reader.getEpochs();
+    Serial.print("Epochs: ");
+    for (int i = 0; i < 3; i++) {
+      Serial.print(epoch[i], 4);
+      Serial.print(" ");
+    }
+    Serial.println();
+    Serial.print("Row 0 Alt/Az: ");
+    myAstro.printDegMinSecs(reader.getAltitude(0)[0]);
+    myAstro.printDegMinSecs(reader.getAzimuth(0)[0]);
+    Serial.println("\n");
+    reader.end();
+    remove("RegressionTests.eph");
+  }
+#endif
+  
+#ifdef SIDEREAL_PLANETS_THREADS
+  Serial.println("Sky state publisher, Moon: 2/26/1979 16:45:00 GMT, Lat 50, Long -100, Elevation 60m");
+  Serial.println("Before publishing: 0 0; after: 1 1, with the Alt/Az of the scalar path");
+  {
+    SiderealSkyPublisher publisher;
+    SiderealSkyState state;
+    Serial.print(publisher.getState(state));
+    Serial.print(" ");
+    Serial.println(publisher.getVersion());
+    myAstro.setLatLong(50.0, -100.0);
+    myAstro.setElevationM(60.0);
+    myAstro.setGMTdate(1979, 2, 26);
+    myAstro.setGMTtime(16, 45, 0.0);
+    myAstro.doMoon();
+    myAstro.doLunarParallax();
+    myAstro.doRAdec2AltAz();
+    publisher.setState(myAstro, SP_MOON);
+    Serial.print(publisher.getState(state));
+    Serial.print(" ");
+    Serial.println(state.version);
+    Serial.print("Scalar Alt/Az:    ");
+    myAstro.printDegMinSecs(myAstro.getAltitude());
+    myAstro.printDegMinSecs(myAstro.getAzimuth());
+    Serial.println();
+    Serial.print("Published Alt/Az: ");
+    myAstro.printDegMinSecs(state.position.altitude);
+    myAstro.printDegMinSecs(state.position.azimuth);
+    Serial.println("\n");
+  }
+#endif
 }
 
 void loop() {
@@ -0,0 +1,111 @@
+/******************************************************************************
+SiderealAirmass.cpp
+Sidereal Planets airmass and extinction curves C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses math.h for math functions
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealAirmass.h"
+
+#ifndef SIDEREAL_PLANETS_NO_REFRACTION
+
+// Public Methods //////////////////////////////////////////////////////////
+// Site latitude and longitude in degrees
+boolean SiderealAirmass::begin(double latitude, double longitude) {
+  if (latitude < -90. || latitude > 90.) return false; //bad input
+  sinLat = sin(latitude * 1.745329252e-2);
+  cosLat = cos(latitude * 1.745329252e-2);
+  this->longitude = longitude;
+  targetCount = 0;
+  return true;
+}
+
+// Pressure in millibars, temperature in Celsius, as for doRefractionC()
+boolean SiderealAirmass::setWeatherC(double pressure, double temperature) {
+  if (temperature <= -273.) return false; //bad input
+  this->pressure = pressure;
+  this->temperature = temperature;
+  return true;
+}
+
+// Extinction in magnitudes per airmass; about 0.2 in V at a good site
+boolean SiderealAirmass::setExtinction(double coefficient) {
+  if (coefficient < 0.) return false; //bad input
+  this->coefficient = coefficient;
+  return true;
+}
+
+// RA (hours) and Dec (degrees) of date of each target.  The arrays are used
+// in place, so they must stay valid while in use.
+boolean SiderealAirmass::setTargets(const double *rightAscensions, const double *declinations, int count) {
+  if (count < 0 || (count > 0 && (rightAscensions == NULL || declinations == NULL))) return false; //bad input
+  targetRA = rightAscensions;
+  targetDec = declinations;
+  targetCount = count;
+  return true;
+}
+
+// Airmass, and if extinction is not NULL the extinction in magnitudes, of
+// every target at stepCount times from startEpoch (days since 1900 January
+// 0.5 GMT) in steps of stepMinutes.  Each array holds stepCount values for
+// the first target, then stepCount for the next, and so on.
+boolean SiderealAirmass::doCurves(double startEpoch, double stepMinutes, int stepCount, float *airmass,
+    float *extinction) {
+  if (airmass == NULL || stepCount < 0) return false; //bad input
+  double lst = SiderealPlanets::calcGMTsiderealTime(startEpoch) + (longitude / 15.0);
+  // Hour angle step: the sky turns 1.0027 sidereal minutes per minute
+  double dh = stepMinutes * 1.00273790935 * 4.363323130e-3;
+  double cosStep = cos(dh), sinStep = sin(dh);
+  for (int k = 0; k < targetCount; k++) {
+    double decRad = targetDec[k] * 1.745329252e-2;
+    double h = (lst - targetRA[k]) * 2.617993878e-1;
+    double a = sin(decRad) * sinLat; // sin(alt) = a + b cos(H)
+    double b = cos(decRad) * cosLat;
+    double cosH = cos(h), sinH = sin(h);
+    float *curve = airmass + ((long)k * stepCount);
+    for (int i = 0; i < stepCount; i++) {
+      curve[i] = calcTargetAirmass(a + (b * cosH));
+      double c = (cosH * cosStep) - (sinH * sinStep);
+      sinH = (sinH * cosStep) + (cosH * sinStep);
+      cosH = c;
+    }
+    if (extinction != NULL) {
+      float *magnitudes = extinction + ((long)k * stepCount);
+      // Below the horizon the extinction is infinite, even with no coefficient
+      for (int i = 0; i < stepCount; i++) magnitudes[i] = isinf(curve[i]) ? INFINITY : curve[i] * coefficient;
+    }
+  }
+  return true;
+}
+
+// Airmass at an apparent (refracted) altitude in degrees, from Kasten and
+// Young (1989): 1 at the zenith, about 38 at the horizon
+double SiderealAirmass::calcAirmass(double altitude) {
+  if (altitude < 0.) return INFINITY;
+  return 1. / (sin(altitude * 1.745329252e-2) + (0.50572 * pow(altitude + 6.07995, -1.6364)));
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+// Refract the geometric altitude as doRefractionC() does, then find the airmass
+float SiderealAirmass::calcTargetAirmass(double sinAltitude) {
+  if (sinAltitude < -0.0175) return INFINITY; // more than a degree down, so never refracted up
+  double altitude = asin(sinAltitude);
+  double r1 = 0.0;
+  double r2 = r1;
+  do {
+    r1 = r2;
+    r2 = SiderealPlanets::calcRefraction(altitude + r1, pressure, temperature);
+  } while (r2 != 0. && fabs(r2 - r1) > 1e-6);
+  return calcAirmass((altitude + r2) * 5.729577951e1);
+}
+
+#endif // SIDEREAL_PLANETS_NO_REFRACTION
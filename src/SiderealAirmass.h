@@ -0,0 +1,59 @@
+/******************************************************************************
+SiderealAirmass.h
+Sidereal Planets airmass and extinction curves Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealAirmass class, as implemented in SiderealAirmass.cpp
+
+Works out the airmass and atmospheric extinction of a list of fixed targets
+over a grid of times, such as every 5 minutes through a night, for ranking
+targets in an observing plan.
+
+The sky only turns between grid times, so the hour angle of each target
+advances by the same angle at every step.  Each target's declination and RA
+terms are worked out once, and the hour angle is stepped by one fixed
+rotation, so no sines or cosines of position are taken per grid point.  The
+geometric altitude is then refracted with the doRefractionC() model, and
+the airmass is found from the apparent altitude with the formula of Kasten
+and Young (1989), which stays good down to the horizon.
+
+Outputs are float arrays holding one curve per target.  Targets below the
+horizon get an infinite airmass and extinction, so they sort last.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealAirmass_h
+#define __SiderealAirmass_h
+
+#include "SiderealPlanets.h"
+
+#ifndef SIDEREAL_PLANETS_NO_REFRACTION
+
+class SiderealAirmass {
+  public:
+    boolean begin(double latitude, double longitude);
+    boolean setWeatherC(double pressure, double temperature);
+    boolean setExtinction(double coefficient);
+    boolean setTargets(const double *rightAscensions, const double *declinations, int count);
+    boolean doCurves(double startEpoch, double stepMinutes, int stepCount, float *airmass, float *extinction = NULL);
+    static double calcAirmass(double altitude);
+
+  private:
+    double sinLat = 0., cosLat = 1.;
+    double longitude = 0.;
+    double pressure = 1010.;   // millibars
+    double temperature = 10.;  // Celsius
+    double coefficient = 0.2;  // magnitudes per airmass
+    const double *targetRA = NULL;  // hours
+    const double *targetDec = NULL; // degrees
+    int targetCount = 0;
+
+    float calcTargetAirmass(double sinAltitude);
+};
+#endif // SIDEREAL_PLANETS_NO_REFRACTION
+#endif
@@ -0,0 +1,225 @@
+/******************************************************************************
+SiderealCache.cpp
+Sidereal Planets sky position cache C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses the C++ standard library containers (std::list, std::unordered_map)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealCache.h"
+
+#ifdef SIDEREAL_PLANETS_HOST
+
+#include <functional>
+
+// Public Methods //////////////////////////////////////////////////////////
+// Capacity in entries, quantum in seconds of time
+boolean SiderealCache::begin(long capacity, double quantumSeconds) {
+  if (capacity < 1 || quantumSeconds <= 0.) return false; //bad input
+  maxEntries = capacity;
+  quantumDays = quantumSeconds / 86400.;
+  clear();
+  resetStats();
+  return true;
+}
+
+// Epoch in days since 1900 January 0.5 GMT, as for setGMTepoch()
+boolean SiderealCache::getPosition(int body, double epoch, const SiderealSite &site, SiderealPosition &position) {
+  if (maxEntries < 1) return false; //begin() not called
+  Key key = makeKey(body, epoch, site);
+  if (lookup(key, position)) return true;
+  if (calcPosition(key, position) == false) return false;
+  insert(key, position);
+  return true;
+}
+
+boolean SiderealCache::getPosition(int body, const SiderealEpoch &epoch, const SiderealSite &site, SiderealPosition &position) {
+  double e;
+  if (calcEpoch(epoch, e) == false) return false;
+  return getPosition(body, e, site, position);
+}
+
+void SiderealCache::clear(void) {
+  entries.clear();
+  index.clear();
+}
+
+long SiderealCache::getSize(void) {
+  return (long)entries.size();
+}
+
+long SiderealCache::getHits(void) {
+  return hits;
+}
+
+long SiderealCache::getMisses(void) {
+  return misses;
+}
+
+long SiderealCache::getEvictions(void) {
+  return evictions;
+}
+
+double SiderealCache::getHitRate(void) {
+  if (hits + misses == 0) return 0.;
+  return (double)hits / (double)(hits + misses);
+}
+
+void SiderealCache::resetStats(void) {
+  hits = 0;
+  misses = 0;
+  evictions = 0;
+}
+
+// Protected Methods ///////////////////////////////////////////////////////
+size_t SiderealCache::KeyHash::operator()(const Key &k) const {
+  std::hash<double> hd;
+  size_t h = std::hash<long long>()(k.slot);
+  h = (h * 31) + (size_t)k.body;
+  h = (h * 31) + hd(k.latitude);
+  h = (h * 31) + hd(k.longitude);
+  h = (h * 31) + hd(k.elevation);
+  return h;
+}
+
+SiderealCache::Key SiderealCache::makeKey(int body, double epoch, const SiderealSite &site) {
+  Key key;
+  key.body = body;
+  key.slot = (long long)floor((epoch / quantumDays) + 0.5);
+  key.latitude = site.latitude;
+  key.longitude = site.longitude;
+  key.elevation = site.elevation;
+  return key;
+}
+
+// On a hit, move the entry to the front of the list
+boolean SiderealCache::lookup(const Key &key, SiderealPosition &position) {
+  std::unordered_map<Key, EntryList::iterator, KeyHash>::iterator it = index.find(key);
+  if (it == index.end()) {
+    misses++;
+    return false;
+  }
+  entries.splice(entries.begin(), entries, it->second);
+  position = it->second->position;
+  hits++;
+  return true;
+}
+
+// Add an entry, dropping the least recently used one when full.
+// Another thread may have added the same key meanwhile; then just refresh it.
+void SiderealCache::insert(const Key &key, const SiderealPosition &position) {
+  std::unordered_map<Key, EntryList::iterator, KeyHash>::iterator it = index.find(key);
+  if (it != index.end()) {
+    entries.splice(entries.begin(), entries, it->second);
+    return;
+  }
+  if ((long)entries.size() >= maxEntries) {
+    index.erase(entries.back().key);
+    entries.pop_back();
+    evictions++;
+  }
+  Entry entry = {key, position};
+  entries.push_front(entry);
+  index[key] = entries.begin();
+}
+
+// Compute the position at the rounded epoch of the key, as runGrid() does
+boolean SiderealCache::calcPosition(const Key &key, SiderealPosition &position) {
+  SiderealPlanets astro{};
+  astro.begin();
+  astro.setLatLong(key.latitude, key.longitude);
+  astro.setElevationM(key.elevation);
+  if (astro.setGMTepoch(key.slot * quantumDays) == false) return false;
+  if (astro.doBody(key.body) == false) return false; //bad body value
+  position.distance = astro.getBodyDistance();
+  if (key.body == SP_MOON) astro.doLunarParallax(); // as seen from the site
+  position.rightAscension = astro.getRAdec();
+  position.declination = astro.getDeclinationDec();
+  astro.doRAdec2AltAz();
+  position.altitude = astro.getAltitude();
+  position.azimuth = astro.getAzimuth();
+  return true;
+}
+
+boolean SiderealCache::calcEpoch(const SiderealEpoch &input, double &epoch) {
+  SiderealPlanets astro{};
+  astro.begin();
+  if (astro.setGMTdate(input.year, input.month, input.day) == false) return false;
+  if (astro.setGMTtime(input.hour, input.minute, input.seconds) == false) return false;
+  epoch = astro.modifiedJulianDate1900() + (astro.getGMT() / 24.);
+  return true;
+}
+
+#ifdef SIDEREAL_PLANETS_THREADS
+// Public Methods //////////////////////////////////////////////////////////
+boolean SiderealSharedCache::begin(long capacity, double quantumSeconds) {
+  std::lock_guard<std::mutex> guard(lock);
+  return cache.begin(capacity, quantumSeconds);
+}
+
+// Look up under the lock, compute a miss without it, then insert under it
+boolean SiderealSharedCache::getPosition(int body, double epoch, const SiderealSite &site, SiderealPosition &position) {
+  SiderealCache::Key key;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (cache.maxEntries < 1) return false; //begin() not called
+    key = cache.makeKey(body, epoch, site);
+    if (cache.lookup(key, position)) return true;
+  }
+  if (cache.calcPosition(key, position) == false) return false;
+  std::lock_guard<std::mutex> guard(lock);
+  cache.insert(key, position);
+  return true;
+}
+
+boolean SiderealSharedCache::getPosition(int body, const SiderealEpoch &epoch, const SiderealSite &site, SiderealPosition &position) {
+  double e;
+  if (SiderealCache::calcEpoch(epoch, e) == false) return false;
+  return getPosition(body, e, site, position);
+}
+
+void SiderealSharedCache::clear(void) {
+  std::lock_guard<std::mutex> guard(lock);
+  cache.clear();
+}
+
+long SiderealSharedCache::getSize(void) {
+  std::lock_guard<std::mutex> guard(lock);
+  return cache.getSize();
+}
+
+long SiderealSharedCache::getHits(void) {
+  std::lock_guard<std::mutex> guard(lock);
+  return cache.getHits();
+}
+
+long SiderealSharedCache::getMisses(void) {
+  std::lock_guard<std::mutex> guard(lock);
+  return cache.getMisses();
+}
+
+long SiderealSharedCache::getEvictions(void) {
+  std::lock_guard<std::mutex> guard(lock);
+  return cache.getEvictions();
+}
+
+double SiderealSharedCache::getHitRate(void) {
+  std::lock_guard<std::mutex> guard(lock);
+  return cache.getHitRate();
+}
+
+void SiderealSharedCache::resetStats(void) {
+  std::lock_guard<std::mutex> guard(lock);
+  cache.resetStats();
+}
+#endif // SIDEREAL_PLANETS_THREADS
+
+#endif // SIDEREAL_PLANETS_HOST
@@ -0,0 +1,115 @@
+/******************************************************************************
+SiderealCache.h
+Sidereal Planets sky position cache Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealCache and SiderealSharedCache classes, as implemented in SiderealCache.cpp
+
+A bounded least-recently-used cache of computed positions, for servers that
+answer many near-identical "where is this body from this site now" queries.
+The key is (body, epoch rounded to the quantum, site).  On a miss the position
+is computed at the rounded epoch, so every query in the same quantum gets the
+same answer no matter which query came first.  The Moon moves about 0.5 arc
+minutes per minute of time, so choose the quantum to suit the accuracy needed.
+
+SiderealSharedCache can be used from many threads at once.  Positions are
+computed outside the lock, so a slow miss does not hold up other queries.
+
+Resources:
+Uses the C++ standard library containers (std::list, std::unordered_map)
+Only built on the host (SIDEREAL_PLANETS_HOST); SiderealSharedCache also
+needs SIDEREAL_PLANETS_THREADS
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealCache_h
+#define __SiderealCache_h
+
+#include "SiderealPlanets.h"
+
+#ifdef SIDEREAL_PLANETS_HOST
+
+#include <list>
+#include <unordered_map>
+#ifdef SIDEREAL_PLANETS_THREADS
+#include <mutex>
+#endif
+
+class SiderealCache {
+  public:
+    boolean begin(long capacity = 1024, double quantumSeconds = 60.);
+    boolean getPosition(int body, double epoch, const SiderealSite &site, SiderealPosition &position);
+    boolean getPosition(int body, const SiderealEpoch &epoch, const SiderealSite &site, SiderealPosition &position);
+    void clear(void);
+    long getSize(void);
+    long getHits(void);
+    long getMisses(void);
+    long getEvictions(void);
+    double getHitRate(void);
+    void resetStats(void);
+
+  private:
+    friend class SiderealSharedCache;
+    struct Key {
+      int body;
+      long long slot; // epoch / quantum, rounded
+      double latitude;
+      double longitude;
+      double elevation;
+      bool operator==(const Key &k) const {
+        return body == k.body && slot == k.slot && latitude == k.latitude &&
+          longitude == k.longitude && elevation == k.elevation;
+      }
+    };
+    struct KeyHash {
+      size_t operator()(const Key &k) const;
+    };
+    struct Entry {
+      Key key;
+      SiderealPosition position;
+    };
+    typedef std::list<Entry> EntryList; // Most recently used first
+
+    long maxEntries = 0;
+    double quantumDays = 1. / 1440.;
+    long hits = 0;
+    long misses = 0;
+    long evictions = 0;
+    EntryList entries;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index;
+
+    Key makeKey(int body, double epoch, const SiderealSite &site);
+    boolean lookup(const Key &key, SiderealPosition &position);
+    void insert(const Key &key, const SiderealPosition &position);
+    boolean calcPosition(const Key &key, SiderealPosition &position);
+    static boolean calcEpoch(const SiderealEpoch &input, double &epoch);
+};
+
+#ifdef SIDEREAL_PLANETS_THREADS
+// The same cache behind a mutex, for query handlers running on many threads
+class SiderealSharedCache {
+  public:
+    boolean begin(long capacity = 1024, double quantumSeconds = 60.);
+    boolean getPosition(int body, double epoch, const SiderealSite &site, SiderealPosition &position);
+    boolean getPosition(int body, const SiderealEpoch &epoch, const SiderealSite &site, SiderealPosition &position);
+    void clear(void);
+    long getSize(void);
+    long getHits(void);
+    long getMisses(void);
+    long getEvictions(void);
+    double getHitRate(void);
+    void resetStats(void);
+
+  private:
+    SiderealCache cache;
+    std::mutex lock;
+};
+#endif // SIDEREAL_PLANETS_THREADS
+
+#endif // SIDEREAL_PLANETS_HOST
+#endif
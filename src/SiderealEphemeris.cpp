@@ -0,0 +1,336 @@
+/******************************************************************************
+SiderealEphemeris.cpp
+Sidereal Planets binary ephemeris file C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses stdio, and mmap() on Linux and macOS
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealEphemeris.h"
+
+#ifdef SIDEREAL_PLANETS_HOST
+
+#include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define SIDEREAL_EPHEMERIS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The file header, 128 bytes
+struct SiderealEphemerisHeader {
+  char magic[8];        // "SPEPHEM" and a zero
+  uint32_t version;     // 1
+  uint32_t byteOrder;   // 0x01020304 as written
+  int64_t rowCount;
+  int32_t bodyCount;
+  int32_t bodies[SP_MOON + 1];
+  double latitude;      // degrees
+  double longitude;     // degrees
+  double elevation;     // meters
+  char reserved[40];
+};
+static_assert(sizeof(SiderealEphemerisHeader) == 128, "ephemeris header must be 128 bytes");
+
+static const char EphemerisMagic[8] = {'S', 'P', 'E', 'P', 'H', 'E', 'M', 0};
+static const uint32_t EphemerisByteOrder = 0x01020304;
+static const int ColumnsPerBody = 5; // RA, Dec, distance, altitude, azimuth
+
+// Bytes from one column to the next, a multiple of 64
+static int64_t calcStride(int64_t rowCount) {
+  return ((rowCount * (int64_t)sizeof(double)) + 63) / 64 * 64;
+}
+
+static boolean seekTo(FILE *file, int64_t offset) {
+#ifdef _WIN32
+  return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+  return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+// Writer Methods //////////////////////////////////////////////////////////
+// An unfinished file is closed without its header
+SiderealEphemerisWriter::~SiderealEphemerisWriter() {
+  if (file != NULL) fclose(file);
+}
+
+// Bodies are SP_SUN to SP_MOON, each at most once
+boolean SiderealEphemerisWriter::begin(const char *path, const SiderealSite &site, const int *bodies, int bodyCount,
+    int64_t rowCount) {
+  if (file != NULL) fclose(file);
+  file = NULL;
+  if (path == NULL || bodies == NULL || bodyCount < 1 || bodyCount > SP_MOON + 1 || rowCount < 0) return false; //bad input
+  if (rowCount > (INT64_MAX - 1024) / ((1 + (bodyCount * ColumnsPerBody)) * (int64_t)sizeof(double))) return false; //too many rows
+  for (int b = 0; b < bodyCount; b++) {
+    if (bodies[b] < SP_SUN || bodies[b] > SP_MOON) return false; //bad body value
+    for (int c = 0; c < b; c++) {
+      if (bodies[c] == bodies[b]) return false; //repeated body
+    }
+    body[b] = bodies[b];
+  }
+  this->site = site;
+  this->bodyCount = bodyCount;
+  this->rowCount = rowCount;
+  rowsWritten = 0;
+  astro.begin();
+  astro.setLatLong(site.latitude, site.longitude);
+  astro.setElevationM(site.elevation);
+  file = fopen(path, "wb+");
+  if (file == NULL) return false;
+  // A blank header for now, and the file at its full size
+  SiderealEphemerisHeader header;
+  memset(&header, 0, sizeof(header));
+  int64_t size = (int64_t)sizeof(header) + ((1 + (bodyCount * ColumnsPerBody)) * calcStride(rowCount));
+  boolean ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  if (ok && size > (int64_t)sizeof(header)) {
+    char zero = 0;
+    ok = seekTo(file, size - 1) && fwrite(&zero, 1, 1, file) == 1;
+  }
+  if (!ok) {
+    // Leave no half-made file open for doRows() or addRows() to write into
+    fclose(file);
+    file = NULL;
+  }
+  return ok;
+}
+
+// Computes the topocentric position of every body at each epoch (days since
+// 1900 January 0.5 GMT) and writes them as the next count rows
+boolean SiderealEphemerisWriter::doRows(const double *epochs, int count) {
+  if (file == NULL || epochs == NULL || count < 0) return false; //bad input
+  block.resize((size_t)count * bodyCount);
+  for (int i = 0; i < count; i++) {
+    if (astro.setGMTepoch(epochs[i]) == false) return false;
+    for (int b = 0; b < bodyCount; b++) {
+      astro.doBody(body[b]);
+      SiderealPosition &p = block[((size_t)b * count) + i];
+      p.rightAscension = astro.getRAdec();
+      p.declination = astro.getDeclinationDec();
+      p.distance = astro.getBodyDistance();
+    }
+  }
+  for (int b = 0; b < bodyCount; b++) {
+    astro.doTopocentric(epochs, &block[(size_t)b * count], count);
+  }
+  return addRows(epochs, block.data(), count);
+}
+
+// Writes count rows computed elsewhere.  positions holds count positions for
+// the first body, then count for the next, and so on.
+boolean SiderealEphemerisWriter::addRows(const double *epochs, const SiderealPosition *positions, int count) {
+  if (file == NULL || epochs == NULL || positions == NULL || count < 0) return false; //bad input
+  if (rowsWritten + count > rowCount) return false; //more rows than begin() said
+  if (putColumn(0, epochs, count) == false) return false;
+  column.resize(count);
+  for (int b = 0; b < bodyCount; b++) {
+    const SiderealPosition *p = positions + ((size_t)b * count);
+    for (int field = 0; field < ColumnsPerBody; field++) {
+      for (int i = 0; i < count; i++) {
+        switch (field) {
+          case 0: column[i] = p[i].rightAscension; break;
+          case 1: column[i] = p[i].declination; break;
+          case 2: column[i] = p[i].distance; break;
+          case 3: column[i] = p[i].altitude; break;
+          default: column[i] = p[i].azimuth; break;
+        }
+      }
+      if (putColumn(1 + (b * ColumnsPerBody) + field, column.data(), count) == false) return false;
+    }
+  }
+  rowsWritten += count;
+  return true;
+}
+
+// Writes the header and closes the file.  Returns false, leaving the file
+// without a header, if fewer rows were written than begin() said.
+boolean SiderealEphemerisWriter::end(void) {
+  if (file == NULL) return false;
+  boolean ok = (rowsWritten == rowCount);
+  if (ok) {
+    SiderealEphemerisHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, EphemerisMagic, sizeof(header.magic));
+    header.version = 1;
+    header.byteOrder = EphemerisByteOrder;
+    header.rowCount = rowCount;
+    header.bodyCount = bodyCount;
+    for (int b = 0; b < bodyCount; b++) header.bodies[b] = body[b];
+    header.latitude = site.latitude;
+    header.longitude = site.longitude;
+    header.elevation = site.elevation;
+    ok = seekTo(file, 0) && fwrite(&header, sizeof(header), 1, file) == 1;
+  }
+  if (fclose(file) != 0) ok = false;
+  file = NULL;
+  return ok;
+}
+
+int64_t SiderealEphemerisWriter::getRowsWritten(void) {
+  return rowsWritten;
+}
+
+// Private: the next rows of column k
+boolean SiderealEphemerisWriter::putColumn(int k, const double *values, int count) {
+  if (count == 0) return true;
+  int64_t offset = (int64_t)sizeof(SiderealEphemerisHeader) + (k * calcStride(rowCount)) +
+    (rowsWritten * (int64_t)sizeof(double));
+  if (seekTo(file, offset) == false) return false;
+  return fwrite(values, sizeof(double), count, file) == (size_t)count;
+}
+
+// Reader Methods //////////////////////////////////////////////////////////
+SiderealEphemerisReader::~SiderealEphemerisReader() {
+  end();
+}
+
+// Maps the file and checks its header.  The columns stay valid until end().
+boolean SiderealEphemerisReader::begin(const char *path) {
+  end();
+  if (path == NULL) return false; //bad input
+#ifdef SIDEREAL_EPHEMERIS_MMAP
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SiderealEphemerisHeader)) {
+    close(fd);
+    return false;
+  }
+  void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd); // the mapping keeps the file open
+  if (p == MAP_FAILED) return false;
+  base = (const unsigned char *)p;
+  size = (size_t)st.st_size;
+  mapped = true;
+#else
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) return false;
+  fseek(f, 0, SEEK_END);
+  long length = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (length < (long)sizeof(SiderealEphemerisHeader)) {
+    fclose(f);
+    return false;
+  }
+  loaded.resize(((size_t)length + sizeof(double) - 1) / sizeof(double));
+  boolean ok = fread(loaded.data(), 1, (size_t)length, f) == (size_t)length;
+  fclose(f);
+  if (!ok) return false;
+  base = (const unsigned char *)loaded.data();
+  size = (size_t)length;
+#endif
+  SiderealEphemerisHeader header;
+  memcpy(&header, base, sizeof(header));
+  boolean ok = memcmp(header.magic, EphemerisMagic, sizeof(header.magic)) == 0 && header.version == 1 &&
+    header.byteOrder == EphemerisByteOrder && header.rowCount >= 0 &&
+    header.bodyCount >= 1 && header.bodyCount <= SP_MOON + 1;
+  for (int b = 0; ok && b < header.bodyCount; b++) {
+    if (header.bodies[b] < SP_SUN || header.bodies[b] > SP_MOON) ok = false;
+  }
+  if (ok) {
+    // Bound the row count by the file size first, so a bad header cannot
+    // overflow the size sums below
+    int64_t columns = 1 + (header.bodyCount * ColumnsPerBody);
+    int64_t rowsFit = ((int64_t)size - (int64_t)sizeof(header)) / (columns * (int64_t)sizeof(double));
+    if (header.rowCount > rowsFit) ok = false; //cut short or bad header
+  }
+  if (ok) {
+    int64_t need = (int64_t)sizeof(header) + ((1 + (header.bodyCount * ColumnsPerBody)) * calcStride(header.rowCount));
+    if ((int64_t)size < need) ok = false; //cut short
+  }
+  if (!ok) {
+    end();
+    return false;
+  }
+  rowCount = header.rowCount;
+  bodyCount = header.bodyCount;
+  for (int b = 0; b < bodyCount; b++) body[b] = header.bodies[b];
+  site.latitude = header.latitude;
+  site.longitude = header.longitude;
+  site.elevation = header.elevation;
+  return true;
+}
+
+void SiderealEphemerisReader::end(void) {
+#ifdef SIDEREAL_EPHEMERIS_MMAP
+  if (mapped) munmap((void *)base, size);
+#endif
+  mapped = false;
+  base = NULL;
+  size = 0;
+  loaded.clear();
+  bodyCount = 0;
+  rowCount = 0;
+}
+
+int64_t SiderealEphemerisReader::getRowCount(void) {
+  return rowCount;
+}
+
+int SiderealEphemerisReader::getBodyCount(void) {
+  return bodyCount;
+}
+
+// Body number (SP_SUN to SP_MOON) of the k'th body in the file
+int SiderealEphemerisReader::getBody(int k) {
+  if (k < 0 || k >= bodyCount) return -1;
+  return body[k];
+}
+
+// Index in the file of a body number, or -1 if it is not there
+int SiderealEphemerisReader::findBody(int body) {
+  for (int b = 0; b < bodyCount; b++) {
+    if (this->body[b] == body) return b;
+  }
+  return -1;
+}
+
+SiderealSite SiderealEphemerisReader::getSite(void) {
+  return site;
+}
+
+SiderealColumn SiderealEphemerisReader::getEpochs(void) {
+  return getColumn(0);
+}
+
+// Columns of the k'th body in the file (see findBody())
+SiderealColumn SiderealEphemerisReader::getRightAscension(int k) {
+  return (k < 0 || k >= bodyCount) ? getColumn(-1) : getColumn(1 + (k * ColumnsPerBody));
+}
+
+SiderealColumn SiderealEphemerisReader::getDeclination(int k) {
+  return (k < 0 || k >= bodyCount) ? getColumn(-1) : getColumn(2 + (k * ColumnsPerBody));
+}
+
+SiderealColumn SiderealEphemerisReader::getDistance(int k) {
+  return (k < 0 || k >= bodyCount) ? getColumn(-1) : getColumn(3 + (k * ColumnsPerBody));
+}
+
+SiderealColumn SiderealEphemerisReader::getAltitude(int k) {
+  return (k < 0 || k >= bodyCount) ? getColumn(-1) : getColumn(4 + (k * ColumnsPerBody));
+}
+
+SiderealColumn SiderealEphemerisReader::getAzimuth(int k) {
+  return (k < 0 || k >= bodyCount) ? getColumn(-1) : getColumn(5 + (k * ColumnsPerBody));
+}
+
+// Private: column k of the file, or an empty column
+SiderealColumn SiderealEphemerisReader::getColumn(int k) {
+  SiderealColumn c = {NULL, 0};
+  if (base == NULL || k < 0) return c;
+  c.data = (const double *)(base + sizeof(SiderealEphemerisHeader) + (k * calcStride(rowCount)));
+  c.count = rowCount;
+  return c;
+}
+
+#endif // SIDEREAL_PLANETS_HOST
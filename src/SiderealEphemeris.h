@@ -0,0 +1,114 @@
+/******************************************************************************
+SiderealEphemeris.h
+Sidereal Planets binary ephemeris file Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealEphemerisWriter and SiderealEphemerisReader
+classes, as implemented in SiderealEphemeris.cpp
+
+Stores sampled positions of several bodies as seen from one site in a
+columnar binary file, so they can be handed on without printing and parsing
+text.  The file is a 128 byte header followed by one column of doubles for
+the epochs, then for each body in turn columns of topocentric RA (hours),
+Dec, distance (AU), altitude and azimuth (degrees).  Every column starts on
+a 64 byte boundary.  Values are in the byte order of the machine that wrote
+the file; the reader rejects a file written in the other order.
+
+The row count is given up front, so each block of rows can go straight to
+its place in every column as it is computed.  The header is written last,
+so a file that was not finished is never read as valid.  The reader maps
+the file into memory and hands out the columns as they lie in the file,
+without copying.
+
+Resources:
+Uses stdio, and mmap() on Linux and macOS (elsewhere the reader loads the
+whole file).  Only built on the host (SIDEREAL_PLANETS_HOST)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealEphemeris_h
+#define __SiderealEphemeris_h
+
+#include "SiderealPlanets.h"
+
+#ifdef SIDEREAL_PLANETS_HOST
+
+#include <stdio.h>
+#include <vector>
+
+// One column of a SiderealEphemerisReader, pointing into the mapped file
+struct SiderealColumn {
+  const double *data;
+  int64_t count;
+  const double &operator[](int64_t i) const { return data[i]; }
+  const double *begin(void) const { return data; }
+  const double *end(void) const { return data + count; }
+};
+
+// Writes a file of rowCount epochs, in blocks of rows, in epoch order or not
+class SiderealEphemerisWriter {
+  public:
+    SiderealEphemerisWriter() = default;
+    SiderealEphemerisWriter(const SiderealEphemerisWriter &) = delete; // owns the open file
+    SiderealEphemerisWriter &operator=(const SiderealEphemerisWriter &) = delete;
+    ~SiderealEphemerisWriter();
+    boolean begin(const char *path, const SiderealSite &site, const int *bodies, int bodyCount, int64_t rowCount);
+    boolean doRows(const double *epochs, int count);
+    boolean addRows(const double *epochs, const SiderealPosition *positions, int count);
+    boolean end(void);
+    int64_t getRowsWritten(void);
+
+  private:
+    FILE *file = NULL;
+    SiderealPlanets astro;
+    SiderealSite site = {0., 0., 0.};
+    int body[SP_MOON + 1];
+    int bodyCount = 0;
+    int64_t rowCount = 0;
+    int64_t rowsWritten = 0;
+    std::vector<SiderealPosition> block; // one block of rows for every body
+    std::vector<double> column;
+
+    boolean putColumn(int k, const double *values, int count);
+};
+
+class SiderealEphemerisReader {
+  public:
+    SiderealEphemerisReader() = default;
+    SiderealEphemerisReader(const SiderealEphemerisReader &) = delete; // owns the mapping
+    SiderealEphemerisReader &operator=(const SiderealEphemerisReader &) = delete;
+    ~SiderealEphemerisReader();
+    boolean begin(const char *path);
+    void end(void);
+    int64_t getRowCount(void);
+    int getBodyCount(void);
+    int getBody(int k);
+    int findBody(int body);
+    SiderealSite getSite(void);
+    SiderealColumn getEpochs(void);
+    SiderealColumn getRightAscension(int k);
+    SiderealColumn getDeclination(int k);
+    SiderealColumn getDistance(int k);
+    SiderealColumn getAltitude(int k);
+    SiderealColumn getAzimuth(int k);
+
+  private:
+    const unsigned char *base = NULL;
+    size_t size = 0;
+    boolean mapped = false;
+    std::vector<double> loaded; // the file, when it cannot be mapped
+    SiderealSite site = {0., 0., 0.};
+    int body[SP_MOON + 1];
+    int bodyCount = 0;
+    int64_t rowCount = 0;
+
+    SiderealColumn getColumn(int k);
+};
+
+#endif // SIDEREAL_PLANETS_HOST
+#endif
@@ -0,0 +1,526 @@
+/******************************************************************************
+SiderealEvents.cpp
+Sidereal Planets eclipse, occultation and planetary event finder C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses math.h for math functions
+Uses SiderealScheduler to work on several lunations, planets or pairs at once
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealEvents.h"
+
+#if defined(SIDEREAL_PLANETS_THREADS) && !defined(SIDEREAL_PLANETS_NO_MOON) && !defined(SIDEREAL_PLANETS_NO_PLANETS)
+
+#include <algorithm>
+
+static const double OneSecond = 1. / 86400.;      // in days
+static const double SynodicMonth = 29.530588861;  // days
+static const double MeanNewMoon = 36530.09766;    // 2000 January 6, in days since 1900 January 0.5
+static const double MaxRate = 18.;      // degrees per day: the Moon moves at most 15.4, Mercury 2.2
+static const double MinStep = 1. / 24.; // walking step near a minimum, days
+static const double MinSkip = 10. / 1440.; // smallest step from above the search limit, days
+static const double SearchLimit = 1.7;  // degrees, above every eclipse and occultation limit
+static const double MoonRadius = 0.272481;      // in Earth radii
+static const double SunSemiDiameter = 0.266563; // degrees at 1 AU
+static const double SunParallax = 0.002443;     // degrees at 1 AU
+static const double GridStep = 2.;      // days between planet samples; Mercury's retrograde arc lasts 3 weeks
+
+// One doPlans() sample
+struct SiderealEvents::PlanetState {
+  double longitude;    // geocentric ecliptic longitude, degrees
+  double sunLongitude; // geocentric ecliptic longitude of the Sun, degrees
+  double elongation;   // angle Sun-Earth-planet, degrees
+  double distance;     // from the Earth, AU
+  double earthDistance; // Earth from the Sun, AU
+};
+
+// Angle difference folded into -180 to +180
+static double inRange180(double d) {
+  d = fmod(d, 360.);
+  if (d < -180.) d += 360.;
+  if (d >= 180.) d -= 360.;
+  return d;
+}
+
+// Angular separation in degrees of two RA (hours) / Dec (degrees) positions.
+// The haversine form keeps its precision at small separations.
+static double calcAngle(double ra1, double dec1, double ra2, double dec2) {
+  double d1 = dec1 * 1.745329252e-2;
+  double d2 = dec2 * 1.745329252e-2;
+  double sdd = sin((d2 - d1) * 0.5);
+  double sda = sin((ra2 - ra1) * 1.308996939e-1); // half the hour difference, radians
+  double h = (sdd * sdd) + (cos(d1) * cos(d2) * sda * sda);
+  if (h > 1.) h = 1.;
+  return 2. * asin(sqrt(h)) * 5.729577951e1;
+}
+
+// Minimum of f between a and b by Brent's method (golden section with
+// parabolic steps), to within tol.  Returns the abscissa; fx gets the value.
+template <class Function> static double calcMinimum(Function f, double a, double b, double tol, double &fx) {
+  const double golden = 0.381966011;
+  double x = a + golden * (b - a);
+  double w = x, v = x;
+  fx = f(x);
+  double fw = fx, fv = fx;
+  double d = 0., e = 0.;
+  for (int i = 0; i < 60; i++) {
+    double m = 0.5 * (a + b);
+    if (fabs(x - m) <= (2. * tol) - (0.5 * (b - a))) break;
+    boolean useGolden = true;
+    if (fabs(e) > tol) {
+      // Try a parabola through x, w and v
+      double r = (x - w) * (fx - fv);
+      double q = (x - v) * (fx - fw);
+      double p = ((x - v) * q) - ((x - w) * r);
+      q = 2. * (q - r);
+      if (q > 0.) p = -p;
+      q = fabs(q);
+      if (fabs(p) < fabs(0.5 * q * e) && p > q * (a - x) && p < q * (b - x)) {
+        e = d;
+        d = p / q;
+        double u = x + d;
+        if ((u - a) < 2. * tol || (b - u) < 2. * tol) d = (x < m) ? tol : -tol;
+        useGolden = false;
+      }
+    }
+    if (useGolden) {
+      e = (x < m) ? b - x : a - x;
+      d = golden * e;
+    }
+    double u = (fabs(d) >= tol) ? x + d : x + ((d > 0.) ? tol : -tol);
+    double fu = f(u);
+    if (fu <= fx) {
+      if (u < x) b = x; else a = x;
+      v = w; fv = fw;
+      w = x; fw = fx;
+      x = u; fx = fu;
+    } else {
+      if (u < x) a = u; else b = u;
+      if (fu <= fw || w == x) {
+        v = w; fv = fw;
+        w = u; fw = fu;
+      } else if (fu <= fv || v == x || v == w) {
+        v = u; fv = fu;
+      }
+    }
+  }
+  return x;
+}
+
+// Root of g between a and b, where ga and gb have opposite signs, by the
+// Illinois form of false position, to within tol
+template <class Function> static double calcRoot(Function g, double a, double ga, double b, double gb, double tol) {
+  int side = 0;
+  double t = a;
+  for (int i = 0; i < 60; i++) {
+    double next = ((a * gb) - (b * ga)) / (gb - ga);
+    if (fabs(next - t) < tol) return next;
+    t = next;
+    double gt = g(t);
+    if (gt == 0.) return t;
+    if ((gt > 0.) == (gb > 0.)) {
+      b = t;
+      gb = gt;
+      if (side == -1) ga *= 0.5; // Same end twice: halve the other to keep it moving
+      side = -1;
+    } else {
+      a = t;
+      ga = gt;
+      if (side == 1) gb *= 0.5;
+      side = 1;
+    }
+  }
+  return t;
+}
+
+// Epochs of the minima of f (a separation in degrees) in [start, end) that
+// fall below limit.  f changes by at most MaxRate degrees per day, so a step
+// of (f - limit) / MaxRate cannot pass a point below the limit.  Close to the
+// limit that step is raised to MinSkip, which can pass over a dip no deeper
+// than MaxRate * MinSkip / 2 (0.0625 degrees) below it; SearchLimit is more
+// than 0.1 degrees above every eclipse and occultation limit, so no event is
+// lost.
+template <class Function> static void findMinima(Function f, double start, double end, double limit,
+    std::vector<double> &out) {
+  double t = start;
+  double ft = f(t);
+  while (t < end) {
+    if (ft > limit) {
+      double step = (ft - limit) / MaxRate;
+      t += (step > MinSkip) ? step : MinSkip;
+      ft = f(t);
+      continue;
+    }
+    // Walk downhill an hour at a time until the minimum is bracketed
+    double h = MinStep;
+    double a = t, fa = ft;
+    double b = t + h, fb = f(b);
+    if (fb >= fa) {
+      h = -MinStep;
+      b = t + h;
+      fb = f(b);
+    }
+    while (fb < fa && fabs(b - t) < 3.) {
+      a = b;
+      fa = fb;
+      b += h;
+      fb = f(b);
+    }
+    double lo = (h > 0.) ? a - h : b;
+    double hi = (h > 0.) ? b : a - h;
+    double fm;
+    double tm = calcMinimum(f, lo, hi, OneSecond, fm);
+    if (fm < limit && tm >= start && tm < end) out.push_back(tm);
+    // Step out of this approach before searching on
+    t = (tm > t) ? tm : t;
+    do {
+      t += MinStep;
+      ft = f(t);
+    } while (ft <= limit && t < end);
+  }
+}
+
+// Public Methods //////////////////////////////////////////////////////////
+boolean SiderealEvents::begin(int workers) {
+  events.clear();
+  evaluations = 0;
+  return scheduler.begin(workers);
+}
+
+// Solar and lunar eclipse candidates with epochs in [startEpoch, endEpoch)
+boolean SiderealEvents::doEclipses(double startEpoch, double endEpoch) {
+  return doLunations(startEpoch, endEpoch, NULL, 0);
+}
+
+// Lunar occultations of the listed planets (SiderealBody numbers from
+// SP_MERCURY to SP_NEPTUNE) with epochs in [startEpoch, endEpoch)
+boolean SiderealEvents::doOccultations(double startEpoch, double endEpoch, const int *bodies, int count) {
+  if (count <= 0 || bodies == NULL) return false; //bad input
+  for (int i = 0; i < count; i++) {
+    if (bodies[i] < SP_MERCURY || bodies[i] > SP_NEPTUNE) return false; //bad input
+  }
+  return doLunations(startEpoch, endEpoch, bodies, count);
+}
+
+int SiderealEvents::getEventCount(void) {
+  return (int)events.size();
+}
+
+SiderealEvent SiderealEvents::getEvent(int k) {
+  SiderealEvent none = {0., 0, 0, 0, 0.};
+  if (k < 0 || k >= getEventCount()) return none;
+  return events[k];
+}
+
+// Conjunctions with the Sun, oppositions, greatest elongations and stations
+// of each listed planet (SP_MERCURY to SP_NEPTUNE), and conjunctions of each
+// pair of them, with epochs in [startEpoch, endEpoch)
+boolean SiderealEvents::doPlanetEvents(double startEpoch, double endEpoch, const int *bodies, int count) {
+  events.clear();
+  evaluations = 0;
+  if (endEpoch <= startEpoch || count <= 0 || bodies == NULL) return false; //bad input
+  std::vector<int> first, second;
+  for (int i = 0; i < count; i++) {
+    if (bodies[i] < SP_MERCURY || bodies[i] > SP_NEPTUNE) return false; //bad input
+    first.push_back(bodies[i]);
+    second.push_back(bodies[i]);
+  }
+  for (int i = 0; i < count; i++) {
+    for (int j = i + 1; j < count; j++) {
+      if (bodies[i] == bodies[j]) continue;
+      first.push_back(bodies[i]);
+      second.push_back(bodies[j]);
+    }
+  }
+  long jobs = (long)first.size();
+  std::vector<std::vector<SiderealEvent> > found(jobs);
+  std::vector<long> calls(jobs, 0);
+  SiderealPlanets astro{};
+  astro.begin();
+  scheduler.setPrototype(astro);
+  boolean done = scheduler.run(jobs, [&](SiderealPlanets &worker, long item, int) {
+    if (item < count) {
+      doPlanet(worker, first[item], startEpoch, endEpoch, found[item], calls[item]);
+    } else {
+      doPair(worker, first[item], second[item], startEpoch, endEpoch, found[item], calls[item]);
+    }
+  }, 1);
+  doMerge(found, calls);
+  return done;
+}
+
+// Number of ephemeris evaluations (one per doBody() call) the last search took
+long SiderealEvents::getEvaluations(void) {
+  return evaluations;
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+// One job per lunation, from one mean new moon to the next.  With no bodies
+// the jobs look for eclipses, otherwise for occultations of the bodies.
+boolean SiderealEvents::doLunations(double startEpoch, double endEpoch, const int *bodies, int count) {
+  events.clear();
+  evaluations = 0;
+  if (endEpoch <= startEpoch) return false; //bad input
+  long first = (long)floor((startEpoch - MeanNewMoon) / SynodicMonth) - 1;
+  long lunations = (long)ceil((endEpoch - MeanNewMoon) / SynodicMonth) - first + 1;
+  std::vector<std::vector<SiderealEvent> > found(lunations);
+  std::vector<long> calls(lunations, 0);
+  std::vector<int> bodyList(bodies, bodies + count);
+  SiderealPlanets astro{};
+  astro.begin();
+  scheduler.setPrototype(astro);
+  boolean done = scheduler.run(lunations, [&](SiderealPlanets &worker, long item, int) {
+    double newMoon = MeanNewMoon + ((first + item) * SynodicMonth);
+    if (bodyList.empty()) {
+      doEclipse(worker, newMoon, false, startEpoch, endEpoch, found[item], calls[item]);
+      doEclipse(worker, newMoon + (0.5 * SynodicMonth), true, startEpoch, endEpoch, found[item], calls[item]);
+    } else {
+      for (size_t b = 0; b < bodyList.size(); b++) {
+        doOccultation(worker, bodyList[b], newMoon, newMoon + SynodicMonth, startEpoch, endEpoch, found[item], calls[item]);
+      }
+    }
+  }, 1);
+  doMerge(found, calls);
+  return done;
+}
+
+// Gather the events of all jobs in time order
+void SiderealEvents::doMerge(const std::vector<std::vector<SiderealEvent> > &found, const std::vector<long> &calls) {
+  for (size_t i = 0; i < found.size(); i++) {
+    events.insert(events.end(), found[i].begin(), found[i].end());
+    evaluations += calls[i];
+  }
+  std::sort(events.begin(), events.end(), [](const SiderealEvent &x, const SiderealEvent &y) {
+    return x.epoch < y.epoch;
+  });
+}
+
+// Eclipse candidate at the new (or full) moon near the mean syzygy epoch
+void SiderealEvents::doEclipse(SiderealPlanets &astro, double syzygy, boolean lunar, double startEpoch, double endEpoch,
+    std::vector<SiderealEvent> &out, long &calls) {
+  // The true syzygy is within a day of the mean one.  Find it from the
+  // longitudes, then check how far the Moon is from its node there.
+  double t = syzygy;
+  double latitude = 0.;
+  for (int i = 0; i < 2; i++) {
+    astro.setGMTepoch(t);
+    astro.doBody(SP_SUN);
+    double sunLongitude = astro.getEclipticLongitude();
+    astro.doBody(SP_MOON);
+    calls += 2;
+    double elongation = astro.getEclipticLongitude() - sunLongitude - (lunar ? 180. : 0.);
+    elongation -= 360. * floor((elongation + 180.) / 360.);
+    t -= elongation / 12.19; // mean daily motion of the Moon from the Sun
+    latitude = astro.getEclipticLatitude();
+  }
+  if (fabs(latitude) > SearchLimit + 0.2) return; //Too far from the node
+  double moonParallax, distance;
+  auto f = [&](double epoch) {
+    calls += 2;
+    return calcSeparation(astro, SP_SUN, lunar, epoch, moonParallax, distance);
+  };
+  std::vector<double> minima;
+  findMinima(f, t - 0.5, t + 0.5, SearchLimit, minima);
+  for (size_t i = 0; i < minima.size(); i++) {
+    if (minima[i] < startEpoch || minima[i] >= endEpoch) continue;
+    double sep = f(minima[i]);
+    double moonSemi = MoonRadius * moonParallax;
+    double sunSemi = SunSemiDiameter / distance;
+    double sunParallax = SunParallax / distance;
+    int type;
+    if (lunar) {
+      // Shadow radii with the customary 2% enlargement for the atmosphere
+      double umbra = 1.02 * (moonParallax + sunParallax - sunSemi);
+      double penumbra = 1.02 * (moonParallax + sunParallax + sunSemi);
+      if (sep >= penumbra + moonSemi) continue;
+      if (sep < umbra - moonSemi) type = SP_LUNAR_TOTAL;
+      else if (sep < umbra + moonSemi) type = SP_LUNAR_PARTIAL;
+      else type = SP_LUNAR_PENUMBRAL;
+    } else {
+      if (sep >= moonParallax - sunParallax + moonSemi + sunSemi) continue;
+      if (sep >= moonParallax - sunParallax) type = SP_SOLAR_PARTIAL;
+      else type = (moonSemi > sunSemi) ? SP_SOLAR_TOTAL : SP_SOLAR_ANNULAR;
+    }
+    out.push_back({minima[i], type, SP_MOON, SP_SUN, sep});
+  }
+}
+
+// Occultations of one planet with epochs in [start, end)
+void SiderealEvents::doOccultation(SiderealPlanets &astro, int body, double start, double end,
+    double startEpoch, double endEpoch, std::vector<SiderealEvent> &out, long &calls) {
+  if (start < startEpoch) start = startEpoch;
+  if (end > endEpoch) end = endEpoch;
+  if (start >= end) return;
+  double moonParallax, distance;
+  auto f = [&](double epoch) {
+    calls += 2;
+    return calcSeparation(astro, body, false, epoch, moonParallax, distance);
+  };
+  std::vector<double> minima;
+  findMinima(f, start, end, SearchLimit, minima);
+  for (size_t i = 0; i < minima.size(); i++) {
+    double sep = f(minima[i]);
+    if (sep >= moonParallax * (1. + MoonRadius)) continue;
+    out.push_back({minima[i], SP_OCCULTATION, SP_MOON, body, sep});
+  }
+}
+
+// Events of one planet relative to the Sun
+void SiderealEvents::doPlanet(SiderealPlanets &astro, int body, double startEpoch, double endEpoch,
+    std::vector<SiderealEvent> &out, long &calls) {
+  // Samples run from one step before startEpoch to one step after endEpoch,
+  // so that turning points near either end are bracketed
+  int n = (int)ceil((endEpoch - startEpoch) / GridStep) + 2;
+  std::vector<PlanetState> s(n + 1);
+  for (int k = 0; k <= n; k++) {
+    calcPlanet(astro, body, startEpoch + ((k - 1) * GridStep), s[k]);
+  }
+  calls += n + 1;
+  PlanetState state;
+  auto elongation = [&](double epoch) {
+    calcPlanet(astro, body, epoch, state);
+    calls++;
+    return inRange180(state.longitude - state.sunLongitude);
+  };
+  auto opposition = [&](double epoch) {
+    return inRange180(elongation(epoch) - 180.);
+  };
+  boolean inner = (body < SP_MARS);
+  for (int k = 1; k <= n; k++) {
+    double a = startEpoch + ((k - 2) * GridStep);
+    double b = a + GridStep;
+    // Conjunction: the longitude difference from the Sun changes sign
+    double ga = inRange180(s[k - 1].longitude - s[k - 1].sunLongitude);
+    double gb = inRange180(s[k].longitude - s[k].sunLongitude);
+    if ((ga < 0.) != (gb < 0.) && fabs(ga) < 90. && fabs(gb) < 90.) {
+      double t = calcRoot(elongation, a, ga, b, gb, OneSecond);
+      calcPlanet(astro, body, t, state); // the last evaluation need not be at t
+      calls++;
+      int type = (inner && state.distance < state.earthDistance) ? SP_INFERIOR_CONJUNCTION : SP_CONJUNCTION;
+      if (t >= startEpoch && t < endEpoch) addEvent(astro, t, type, body, SP_SUN, out, calls);
+    }
+    ga = inRange180(ga - 180.);
+    gb = inRange180(gb - 180.);
+    if (!inner && (ga < 0.) != (gb < 0.) && fabs(ga) < 90. && fabs(gb) < 90.) {
+      double t = calcRoot(opposition, a, ga, b, gb, OneSecond);
+      if (t >= startEpoch && t < endEpoch) addEvent(astro, t, SP_OPPOSITION, body, SP_SUN, out, calls);
+    }
+    if (k == n) break;
+    // Station: the longitude turns back between samples k - 1 and k + 1
+    double before = inRange180(s[k].longitude - s[k - 1].longitude);
+    double after = inRange180(s[k + 1].longitude - s[k].longitude);
+    if ((before > 0.) != (after > 0.)) {
+      double sign = (before > 0.) ? -1. : 1.; // a maximum for a retrograde station
+      double center = s[k].longitude;
+      auto longitude = [&](double epoch) {
+        calcPlanet(astro, body, epoch, state);
+        calls++;
+        return sign * inRange180(state.longitude - center);
+      };
+      double f;
+      double t = calcMinimum(longitude, a, b + GridStep, OneSecond, f);
+      int type = (before > 0.) ? SP_STATION_RETROGRADE : SP_STATION_DIRECT;
+      if (t >= startEpoch && t < endEpoch) addEvent(astro, t, type, body, SP_SUN, out, calls);
+    }
+    // Greatest elongation of Mercury or Venus: the elongation peaks at sample k
+    if (inner && s[k].elongation >= s[k - 1].elongation && s[k].elongation > s[k + 1].elongation) {
+      auto angle = [&](double epoch) {
+        calcPlanet(astro, body, epoch, state);
+        calls++;
+        return -state.elongation;
+      };
+      double f;
+      double t = calcMinimum(angle, a, b + GridStep, OneSecond, f);
+      calcPlanet(astro, body, t, state);
+      calls++;
+      int type = (inRange180(state.longitude - state.sunLongitude) > 0.) ? SP_GREATEST_EAST : SP_GREATEST_WEST;
+      if (t >= startEpoch && t < endEpoch) addEvent(astro, t, type, body, SP_SUN, out, calls);
+    }
+  }
+}
+
+// Conjunctions in longitude of two planets
+void SiderealEvents::doPair(SiderealPlanets &astro, int body, int otherBody, double startEpoch, double endEpoch,
+    std::vector<SiderealEvent> &out, long &calls) {
+  PlanetState one, other;
+  auto difference = [&](double epoch) {
+    calcPlanet(astro, body, epoch, one);
+    calcPlanet(astro, otherBody, epoch, other);
+    calls += 2;
+    return inRange180(one.longitude - other.longitude);
+  };
+  double a = startEpoch;
+  double ga = difference(a);
+  while (a < endEpoch) {
+    double b = a + GridStep;
+    double gb = difference(b);
+    if ((ga < 0.) != (gb < 0.) && fabs(ga) < 90. && fabs(gb) < 90.) {
+      double t = calcRoot(difference, a, ga, b, gb, OneSecond);
+      if (t < endEpoch) addEvent(astro, t, SP_PLANET_CONJUNCTION, body, otherBody, out, calls);
+    }
+    a = b;
+    ga = gb;
+  }
+}
+
+// One doPlans() call gives the planet's longitude and, from the heliocentric
+// longitudes and radius vectors of the planet and the Earth, its elongation
+void SiderealEvents::calcPlanet(SiderealPlanets &astro, int body, double epoch, PlanetState &state) {
+  astro.setGMTepoch(epoch);
+  astro.doPlans(body);
+  state.longitude = astro.getEclipticLongitude();
+  double earth = astro.getEarthHelioLong();
+  state.sunLongitude = earth + 180.;
+  double r = astro.getRadiusVec();
+  double cosLat = cos(astro.getHelioLat() * 1.745329252e-2);
+  double R = astro.getEarthRadiusVec();
+  double c = r * cosLat * cos((astro.getHelioLong() - earth) * 1.745329252e-2);
+  double d2 = (R * R) + (r * r) - (2. * R * c);
+  state.distance = sqrt(d2);
+  state.earthDistance = R;
+  double cosE = ((R * R) + d2 - (r * r)) / (2. * R * state.distance);
+  if (cosE > 1.) cosE = 1.;
+  if (cosE < -1.) cosE = -1.;
+  state.elongation = acos(cosE) * 5.729577951e1;
+}
+
+// Record an event with the geocentric separation of the two bodies
+void SiderealEvents::addEvent(SiderealPlanets &astro, double epoch, int type, int body, int otherBody,
+    std::vector<SiderealEvent> &out, long &calls) {
+  astro.setGMTepoch(epoch);
+  astro.doBody(body);
+  double ra = astro.getRAdec();
+  double dec = astro.getDeclinationDec();
+  astro.doBody(otherBody);
+  calls += 2;
+  out.push_back({epoch, type, body, otherBody, calcAngle(ra, dec, astro.getRAdec(), astro.getDeclinationDec())});
+}
+
+// Geocentric separation in degrees of the Moon from a body, or from the
+// point opposite it.  Also gives the Moon's horizontal parallax in degrees
+// and the body's distance in AU.
+double SiderealEvents::calcSeparation(SiderealPlanets &astro, int body, boolean opposite, double epoch,
+    double &moonParallax, double &distance) {
+  astro.setGMTepoch(epoch);
+  astro.doBody(body);
+  double ra = astro.getRAdec();
+  double dec = astro.getDeclinationDec();
+  distance = astro.getBodyDistance();
+  if (opposite) {
+    ra += 12.;
+    dec = -dec;
+  }
+  astro.doBody(SP_MOON);
+  moonParallax = asin(4.263523e-5 / astro.getBodyDistance()) * 5.729577951e1;
+  return calcAngle(astro.getRAdec(), astro.getDeclinationDec(), ra, dec);
+}
+
+#endif // SIDEREAL_PLANETS_THREADS
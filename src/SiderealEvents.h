@@ -0,0 +1,123 @@
+/******************************************************************************
+SiderealEvents.h
+Sidereal Planets eclipse, occultation and planetary event finder Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealEvents class, as implemented in SiderealEvents.cpp
+
+Searches long date ranges for solar and lunar eclipse candidates and for
+lunar occultations of the planets.  Each lunation is an independent job:
+
+- Eclipses can only happen when the Moon is near a node of its orbit at new
+  or full moon.  The Moon's ecliptic latitude from doMoon() at mean new and
+  full moon rules out most syzygies with one evaluation.
+- The geocentric separation of the Moon from the Sun (or from the point
+  opposite the Sun, for lunar eclipses, or from a planet) cannot change faster
+  than the Moon moves.  So while the separation is well above the limit, the
+  search steps ahead by (separation - limit) / maximum rate, which covers a
+  lunation in a handful of evaluations instead of hundreds of hourly ones.
+- Inside the limit, the minimum is bracketed and refined by Brent's method
+  to about one second of time.
+
+Limits use the horizontal parallax and semi-diameter of the Moon (from the
+same terms doMoon() uses for moonHorizontalParallax) and of the Sun at the
+minimum, as in the Explanatory Supplement.  The results are candidates from
+geocentric positions of the library's accuracy (an arcminute or two for the
+Moon), so eclipses and occultations right at the limits may be misjudged.
+
+Planetary events (conjunctions with the Sun or between planets,
+oppositions, greatest elongations and stations) come from a 2-day grid of
+doPlans() results.  Each sample gives the planet's geocentric longitude, and
+getHelioLong(), getRadiusVec(), getEarthHelioLong() and getEarthRadiusVec()
+give the Sun-Earth-planet triangle for the elongation without a doSun() call.
+Sign changes of the longitude difference, and turning points of the
+longitude and elongation, are bracketed on the grid and refined to about one
+second.  Each planet, and each pair of planets, is a separate job.
+
+Times are epochs in days since 1900 January 0.5 GMT (see setGMTepoch()).
+
+Resources:
+Uses SiderealScheduler to work on several lunations, planets or pairs at once
+Only built when SIDEREAL_PLANETS_THREADS is defined (the default on the host),
+and not when the Moon or planets are left out of the build
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealEvents_h
+#define __SiderealEvents_h
+
+#include "SiderealScheduler.h"
+
+#if defined(SIDEREAL_PLANETS_THREADS) && !defined(SIDEREAL_PLANETS_NO_MOON) && !defined(SIDEREAL_PLANETS_NO_PLANETS)
+
+#include <vector>
+
+enum SiderealEventType {
+  SP_SOLAR_PARTIAL = 0,  // Moon's penumbra touches the Earth
+  SP_SOLAR_ANNULAR = 1,  // shadow axis hits the Earth, Moon smaller than Sun
+  SP_SOLAR_TOTAL = 2,    // shadow axis hits the Earth, Moon larger than Sun
+  SP_LUNAR_PENUMBRAL = 3,
+  SP_LUNAR_PARTIAL = 4,
+  SP_LUNAR_TOTAL = 5,
+  SP_OCCULTATION = 6,    // Moon covers the planet as seen from somewhere on Earth
+  SP_CONJUNCTION = 7,    // planet and Sun at the same longitude (superior conjunction for Mercury and Venus)
+  SP_INFERIOR_CONJUNCTION = 8,
+  SP_OPPOSITION = 9,
+  SP_GREATEST_EAST = 10, // greatest eastern (evening) elongation
+  SP_GREATEST_WEST = 11, // greatest western (morning) elongation
+  SP_STATION_RETROGRADE = 12,
+  SP_STATION_DIRECT = 13,
+  SP_PLANET_CONJUNCTION = 14 // two planets at the same geocentric longitude
+};
+
+// One event found by a search
+struct SiderealEvent {
+  double epoch;      // days since 1900 January 0.5 GMT
+  int type;          // SiderealEventType
+  int body;          // SiderealBody numbers of the two bodies involved: SP_MOON and SP_SUN
+  int otherBody;     //   for eclipses, SP_MOON and the planet for occultations, the planet
+                     //   and SP_SUN for planetary events, or two planets
+  double separation; // geocentric angular separation at the event, degrees
+};
+
+class SiderealEvents {
+  public:
+    boolean begin(int workers = 0);
+    boolean doEclipses(double startEpoch, double endEpoch);
+    boolean doOccultations(double startEpoch, double endEpoch, const int *bodies, int count);
+    boolean doPlanetEvents(double startEpoch, double endEpoch, const int *bodies, int count);
+    int getEventCount(void);
+    SiderealEvent getEvent(int k);
+    long getEvaluations(void);
+
+  private:
+    struct PlanetState; // Defined in SiderealEvents.cpp
+
+    SiderealScheduler scheduler;
+    std::vector<SiderealEvent> events;
+    long evaluations = 0;
+
+    boolean doLunations(double startEpoch, double endEpoch, const int *bodies, int count);
+    void doEclipse(SiderealPlanets &astro, double syzygy, boolean lunar, double startEpoch, double endEpoch,
+      std::vector<SiderealEvent> &out, long &calls);
+    void doOccultation(SiderealPlanets &astro, int body, double start, double end,
+      double startEpoch, double endEpoch, std::vector<SiderealEvent> &out, long &calls);
+    void doMerge(const std::vector<std::vector<SiderealEvent> > &found, const std::vector<long> &calls);
+    void doPlanet(SiderealPlanets &astro, int body, double startEpoch, double endEpoch,
+      std::vector<SiderealEvent> &out, long &calls);
+    void doPair(SiderealPlanets &astro, int body, int otherBody, double startEpoch, double endEpoch,
+      std::vector<SiderealEvent> &out, long &calls);
+    void calcPlanet(SiderealPlanets &astro, int body, double epoch, PlanetState &state);
+    void addEvent(SiderealPlanets &astro, double epoch, int type, int body, int otherBody,
+      std::vector<SiderealEvent> &out, long &calls);
+    double calcSeparation(SiderealPlanets &astro, int body, boolean opposite, double epoch,
+      double &moonParallax, double &distance);
+};
+
+#endif // SIDEREAL_PLANETS_THREADS
+#endif
@@ -0,0 +1,240 @@
+/******************************************************************************
+SiderealHorizon.cpp
+Sidereal Planets horizon mask rise and set C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses math.h for math functions
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealHorizon.h"
+
+static const double OneSecond = 1. / 86400.;      // in days
+static const double SiderealRate = 1.00273790935; // sidereal hours per solar hour
+static const double MaxStep = 1. / 72.;           // days, near the skyline
+
+// Hour difference folded into -12 to +12
+static double inRange12(double h) {
+  h = fmod(h, 24.);
+  if (h < -12.) h += 24.;
+  if (h >= 12.) h -= 24.;
+  return h;
+}
+
+// Azimuth difference folded into -180 to +180
+static double inRange180(double d) {
+  d = fmod(d, 360.);
+  if (d < -180.) d += 360.;
+  if (d >= 180.) d -= 360.;
+  return d;
+}
+
+// Public Methods //////////////////////////////////////////////////////////
+// Degrees, with elevation in meters
+boolean SiderealHorizon::begin(double latitude, double longitude, double elevation) {
+  if (latitude < -90. || latitude > 90.) return false; //bad input
+  astro.begin();
+  astro.setLatLong(latitude, longitude);
+  astro.setElevationM(elevation);
+  sinLat = sin(latitude * 1.745329252e-2);
+  cosLat = cos(latitude * 1.745329252e-2);
+  mask = NULL;
+  maskCount = 0;
+  maskLow = maskHigh = maskSlope = 0.;
+  eventCount = 0;
+  return true;
+}
+
+// Skyline altitudes in degrees at azimuths 0, 360 / count, 2 * 360 / count...
+// from North through East.  A count of 0 gives a flat horizon at 0 degrees.
+boolean SiderealHorizon::setMask(const float *altitudes, int count) {
+  if (count < 0 || (count > 0 && altitudes == NULL)) return false; //bad input
+  mask = altitudes;
+  maskCount = count;
+  maskLow = maskHigh = (count > 0) ? altitudes[0] : 0.;
+  maskSlope = 0.;
+  for (int i = 0; i < count; i++) {
+    if (altitudes[i] < maskLow) maskLow = altitudes[i];
+    if (altitudes[i] > maskHigh) maskHigh = altitudes[i];
+    double rise = fabs(altitudes[(i + 1 < count) ? i + 1 : 0] - altitudes[i]) * count / 360.;
+    if (rise > maskSlope) maskSlope = rise;
+  }
+  return true;
+}
+
+double SiderealHorizon::getMaskAltitude(double azimuth) {
+  if (maskCount == 0) return 0.;
+  double x = fmod(azimuth, 360.) * maskCount / 360.;
+  if (x < 0.) x += maskCount;
+  int i = (int)x;
+  if (i >= maskCount) i = 0;
+  int j = (i + 1 < maskCount) ? i + 1 : 0;
+  return mask[i] + ((x - i) * (mask[j] - mask[i]));
+}
+
+// Risings and settings of a body (SP_SUN to SP_MOON) over the skyline with
+// epochs in [startEpoch, endEpoch].  The body is up when its geometric
+// altitude plus displacement (degrees, as for doRiseSetTimes()) is above the
+// skyline.
+boolean SiderealHorizon::doRiseSet(int body, double startEpoch, double endEpoch, double displacement) {
+  if (body < SP_SUN || body > SP_MOON) return false; //bad body value
+  targetBody = body;
+  targetDisplacement = displacement;
+  return findEvents(startEpoch, endEpoch);
+}
+
+// The same for a fixed RA (hours) and Dec (degrees) of date
+boolean SiderealHorizon::doRiseSet(double rightAscension, double declination, double startEpoch, double endEpoch,
+    double displacement) {
+  targetBody = -1;
+  targetRA = rightAscension;
+  targetDec = declination;
+  targetDisplacement = displacement;
+  return findEvents(startEpoch, endEpoch);
+}
+
+boolean SiderealHorizon::getVisibleAtStart(void) {
+  return visibleAtStart;
+}
+
+int SiderealHorizon::getEventCount(void) {
+  return eventCount;
+}
+
+double SiderealHorizon::getEventTime(int k) {
+  if (k < 0 || k >= eventCount) return 0.;
+  return eventTime[k];
+}
+
+double SiderealHorizon::getEventAzimuth(int k) {
+  if (k < 0 || k >= eventCount) return 0.;
+  return eventAzimuth[k];
+}
+
+boolean SiderealHorizon::getEventRising(int k) {
+  if (k < 0 || k >= eventCount) return false;
+  return eventRising[k];
+}
+
+// Number of positions computed by the last search
+long SiderealHorizon::getEvaluations(void) {
+  return evaluations;
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+// Returns false if the range is bad or there were more than MaxEvents events
+boolean SiderealHorizon::findEvents(double startEpoch, double endEpoch) {
+  eventCount = 0;
+  evaluations = 0;
+  if (endEpoch < startEpoch) return false; //bad input
+  // Fastest the altitude can change, in degrees per day: the sky turns at
+  // 15.04 degrees an hour, and the Moon adds up to 0.7
+  double rate = ((15.05 * cosLat) + 0.7) * 24.;
+  // Fastest the azimuth can change below the highest ridge, in degrees per
+  // day, and so the fastest the skyline altitude under the body can change
+  double top = fabs(maskHigh - targetDisplacement) + 1.;
+  if (top > 80.) top = 80.;
+  double azimuthBound = ((15.05 * (fabs(sinLat) + (cosLat * tan(top * 1.745329252e-2)))) + 1.) * 24.;
+  double clearanceRate = rate + (maskSlope * azimuthBound);
+  double cell = (maskCount > 0) ? 360. / maskCount : 360.;
+  double altitude, azimuth;
+  double t = startEpoch;
+  double ft = calcClearance(t, altitude, azimuth);
+  double azimuthRate = 0.; // degrees per day over the last step
+  visibleAtStart = (ft >= 0.);
+  while (t < endEpoch) {
+    // Step one mask entry of azimuth at a time, or further when the body is
+    // too far from the skyline, or from every ridge, to reach it sooner
+    double step = MaxStep;
+    if (azimuthRate * step > cell) step = cell / azimuthRate;
+    double ahead = fabs(ft) / clearanceRate;
+    double height = altitude + targetDisplacement;
+    if (height > maskHigh && (height - maskHigh) / rate > ahead) ahead = (height - maskHigh) / rate;
+    if (height < maskLow && (maskLow - height) / rate > ahead) ahead = (maskLow - height) / rate;
+    if (ahead > step) step = ahead;
+    if (step < OneSecond * 10.) step = OneSecond * 10.;
+    if (t + step > endEpoch) step = endEpoch - t;
+    double next = t + step;
+    double altNext, azNext;
+    double fn = calcClearance(next, altNext, azNext);
+    // Passed more than one mask entry: come back, but not closer than ahead
+    while (fabs(inRange180(azNext - azimuth)) > cell && step > ahead && step > OneSecond * 10.) {
+      step *= 0.5;
+      if (step < ahead) step = ahead;
+      next = t + step;
+      fn = calcClearance(next, altNext, azNext);
+    }
+    if ((fn >= 0.) != (ft >= 0.)) {
+      if (eventCount == MaxEvents) return false; //no room left
+      double edge = calcCrossing(t, ft, next, fn);
+      double a, z;
+      calcClearance(edge, a, z);
+      eventTime[eventCount] = edge;
+      eventAzimuth[eventCount] = z;
+      eventRising[eventCount] = (fn >= 0.);
+      eventCount++;
+    }
+    azimuthRate = fabs(inRange180(azNext - azimuth)) / (next - t);
+    t = next;
+    ft = fn;
+    altitude = altNext;
+    azimuth = azNext;
+  }
+  return true;
+}
+
+// Altitude plus displacement above the skyline, in degrees.  Also gives the
+// geometric altitude and azimuth, and leaves the RA/Dec of date in astro.
+double SiderealHorizon::calcClearance(double epoch, double &altitude, double &azimuth) {
+  evaluations++;
+  astro.setGMTepoch(epoch);
+  if (targetBody < 0) {
+    astro.setRAdec(targetRA, targetDec);
+  } else {
+    astro.doBody(targetBody);
+    if (targetBody == SP_MOON) astro.doLunarParallax();
+  }
+  astro.doRAdec2AltAz();
+  altitude = astro.getAltitude();
+  azimuth = astro.getAzimuth();
+  return altitude + targetDisplacement - getMaskAltitude(azimuth);
+}
+
+// Epoch when the clearance crosses zero between a and b, where fa and fb have
+// opposite signs.  As in doRiseSetTimes(), the hour angle at which the
+// current declination reaches the skyline altitude at the current azimuth
+// gives the next guess.  Guesses outside the bracket fall back to bisection.
+double SiderealHorizon::calcCrossing(double a, double fa, double b, double fb) {
+  boolean rising = (fa < fb);
+  double t = a + ((b - a) * fa) / (fa - fb);
+  for (int i = 0; i < 30; i++) {
+    double altitude, azimuth;
+    double ft = calcClearance(t, altitude, azimuth);
+    if ((ft >= 0.) == (fa >= 0.)) {
+      a = t;
+      fa = ft;
+    } else {
+      b = t;
+    }
+    double next = 0.5 * (a + b);
+    double limit = (getMaskAltitude(azimuth) - targetDisplacement) * 1.745329252e-2;
+    double dec = astro.getDeclinationDec() * 1.745329252e-2;
+    double cosH = (sin(limit) - (sinLat * sin(dec))) / (cosLat * cos(dec));
+    if (cosH >= -1. && cosH <= 1.) {
+      double h = acos(cosH) * 3.819718634; // radians to hours
+      double lst = rising ? astro.getRAdec() - h : astro.getRAdec() + h;
+      double guess = t + inRange12(lst - astro.getLocalSiderealTime()) / (SiderealRate * 24.);
+      if (guess > a && guess < b) next = guess;
+    }
+    if (fabs(next - t) < OneSecond || (b - a) < OneSecond) return next;
+    t = next;
+  }
+  return t;
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+SiderealHorizon.h
+Sidereal Planets horizon mask rise and set Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealHorizon class, as implemented in SiderealHorizon.cpp
+
+doRiseSetTimes() assumes a flat horizon.  In a valley the Sun rises when it
+clears the ridge, which depends on where along the skyline it comes up.  A
+horizon mask is a table of the skyline altitude at equal azimuth steps from
+North through East, linearly interpolated between entries.
+
+The solver works out rising and setting against the mask without a minute
+by minute sweep:
+- While the body is above the highest point of the skyline, or below the
+  lowest, no crossing is possible until its altitude could have changed by
+  the difference, so it steps ahead that far.
+- Between those altitudes, it samples often enough that the body cannot
+  pass a whole mask entry in azimuth between samples.
+- Each crossing is refined like doRiseSetTimes(): the hour angle at which
+  the body reaches the skyline altitude at its current azimuth gives the
+  next guess, kept inside the bracketing samples.
+Event times are good to about one second.
+
+Times are epochs in days since 1900 January 0.5 GMT (see setGMTepoch()).
+
+Resources:
+The mask array is used in place, so it must stay valid while in use.
+Holds up to 32 events per search.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealHorizon_h
+#define __SiderealHorizon_h
+
+#include "SiderealPlanets.h"
+
+class SiderealHorizon {
+  public:
+    boolean begin(double latitude, double longitude, double elevation);
+    boolean setMask(const float *altitudes, int count);
+    double getMaskAltitude(double azimuth);
+    boolean doRiseSet(int body, double startEpoch, double endEpoch, double displacement = 0.);
+    boolean doRiseSet(double rightAscension, double declination, double startEpoch, double endEpoch,
+      double displacement = 0.);
+    boolean getVisibleAtStart(void);
+    int getEventCount(void);
+    double getEventTime(int k);
+    double getEventAzimuth(int k);
+    boolean getEventRising(int k);
+    long getEvaluations(void);
+
+  private:
+    static constexpr int MaxEvents = 32;
+
+    SiderealPlanets astro;
+    double sinLat = 0., cosLat = 1.;
+    const float *mask = NULL; // skyline altitudes, degrees
+    int maskCount = 0;
+    double maskLow = 0., maskHigh = 0.;
+    double maskSlope = 0.; // steepest skyline, degrees of altitude per degree of azimuth
+    int targetBody = SP_SUN;   // -1 for a fixed position
+    double targetRA = 0., targetDec = 0.;
+    double targetDisplacement = 0.;
+    boolean visibleAtStart = false;
+    int eventCount = 0;
+    double eventTime[MaxEvents];
+    float eventAzimuth[MaxEvents];
+    boolean eventRising[MaxEvents];
+    long evaluations = 0;
+
+    boolean findEvents(double startEpoch, double endEpoch);
+    double calcClearance(double epoch, double &altitude, double &azimuth);
+    double calcCrossing(double a, double fa, double b, double fb);
+};
+#endif
@@ -0,0 +1,130 @@
+/******************************************************************************
+SiderealMath.h
+Sidereal Planets compile-time date and sidereal time helpers
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+constexpr versions of the calendar, sidereal time and precession formulas
+used by the SiderealPlanets class, which calls these same functions.  With
+constant arguments the compiler evaluates them at build time, so firmware
+with a fixed catalog epoch or a fixed deployment date can keep the results
+in flash instead of computing them at every boot:
+
+  constexpr double launchDay = siderealMJD1900(2025, 5, 24);
+  constexpr SiderealMatrix toJ2000 = siderealPrecessionMatrix(launchDay);
+
+They are written as single return statements, so C++11 compilers (such as
+the Arduino AVR toolchain) accept them.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealMath_h
+#define __SiderealMath_h
+
+// Largest whole number not above x
+constexpr double siderealFloor(double x) {
+  return ((double)(long long)x > x) ? (double)(long long)x - 1.0 : (double)(long long)x;
+}
+
+// x folded into 0 <= x < range
+constexpr double siderealRange(double x, double range) {
+  return x - (range * siderealFloor(x / range));
+}
+
+// Day of week for a Gregorian date, 0 (Sunday) through 6 (Saturday).
+// Devised by Tomohiko Sakamoto in 1993; the string holds his month table.
+constexpr int siderealDayOfWeekY(int y, int month, int day) {
+  return (y + (y / 4) - (y / 100) + (y / 400) + ("032503514624"[month - 1] - '0') + day) % 7;
+}
+constexpr int siderealDayOfWeek(int year, int month, int day) {
+  return siderealDayOfWeekY(year - ((month < 3) ? 1 : 0), month, day);
+}
+
+// Days since 1900 January 0.5 at 0h GMT of a date, Julian calendar before
+// 1582 October 15 and Gregorian after.  Returns -9999999 for the dates
+// dropped in the 1582 calendar change.
+constexpr int siderealCalendar(int y1, int month, int day) {
+  return (y1 > 1582) ? 1 : (y1 < 1582) ? 0 : (month < 10) ? 0 :
+    (month == 10 && day < 5) ? 0 : (month > 10 || day > 14) ? 1 : -1;
+}
+constexpr long siderealGregorianDays(int y1) {
+  return 2 - (y1 / 100) + ((y1 / 100) / 4);
+}
+constexpr double siderealMJD1900Y(int y1, int m1, int calendar, int day) {
+  return (calendar < 0) ? -9999999. :
+    (double)(((calendar > 0) ? siderealGregorianDays(y1) : 0L) +
+    ((y1 < 0) ? (long)((365.25 * y1) - 0.75) : (long)(365.25 * y1)) - 694025L +
+    (long)(30.6001 * (m1 + 1)) + day) - 0.5;
+}
+constexpr double siderealMJD1900(int year, int month, int day) {
+  // There is no year zero, and January and February count as months 13 and 14
+  return siderealMJD1900Y(((year < 1) ? year + 1 : year) - ((month < 3) ? 1 : 0),
+    (month < 3) ? month + 12 : month,
+    siderealCalendar(((year < 1) ? year + 1 : year) - ((month < 3) ? 1 : 0), month, day), day);
+}
+
+// Greenwich sidereal time in hours at 0h GMT of the day holding mjd1900.
+// Subtracting whole centuries of the year keeps 2400 * t small and precise.
+constexpr double siderealGST0T(double t, int year) {
+  return siderealRange((t * (5.13366e-2 + (t * (2.586222e-5 - (t * 1.722e-9))))) +
+    6.697374558 + (2400.0 * (t - ((year - 2000.0) / 100.0))), 24.0);
+}
+constexpr double siderealGST0(double mjd1900, int year) {
+  return siderealGST0T(((((long)(mjd1900 - 0.5)) + 0.5) / 36525.0) - 1.0, year);
+}
+
+// Greenwich sidereal time in hours, as getGMTsiderealTime()
+constexpr double siderealGMST(double mjd1900, int year, double gmtHours) {
+  return siderealRange((gmtHours * 1.002737908) + siderealGST0(mjd1900, year), 24.0);
+}
+
+// Sine and cosine by series, for the small precession angles (under a
+// radian for dates within 5000 years of 2000)
+constexpr double siderealSinSeries(double x2, double term, int n, double sum) {
+  return (n > 31) ? sum : siderealSinSeries(x2, -term * x2 / ((n + 1) * (n + 2)), n + 2, sum + term);
+}
+constexpr double siderealSin(double x) {
+  return siderealSinSeries(x * x, x, 1, 0.0);
+}
+constexpr double siderealCos(double x) {
+  return siderealSinSeries(x * x, 1.0, 0, 0.0);
+}
+
+// Precession angles in radians, for t in Julian centuries from 2000 January 1.5
+constexpr double siderealPrecessionXA(double t) {
+  return ((((0.000005 * t) + 0.0000839) * t + 0.6406161) * t) * 1.745329252e-2;
+}
+constexpr double siderealPrecessionZA(double t) {
+  return ((((0.0000051 * t) + 0.0003041) * t + 0.6406161) * t) * 1.745329252e-2;
+}
+constexpr double siderealPrecessionTA(double t) {
+  return ((((-0.0000116 * t) - 0.0001185) * t + 0.556753) * t) * 1.745329252e-2;
+}
+
+// Rotation from the equator of date to that of 2000.0; its transpose goes back
+struct SiderealMatrix {
+  double m[3][3];
+};
+
+constexpr SiderealMatrix siderealPrecessionTrig(double c1, double c2, double c3, double s1, double s2, double s3) {
+  return SiderealMatrix{{
+    {c1 * c3 * c2 - s1 * s2, -s1 * c3 * c2 - c1 * s2, -s3 * c2},
+    {c1 * c3 * s2 + s1 * c2, -s1 * c3 * s2 + c1 * c2, -s3 * s2},
+    {c1 * s3, -s1 * s3, c3}
+  }};
+}
+constexpr SiderealMatrix siderealPrecessionT(double xa, double za, double ta) {
+  return siderealPrecessionTrig(siderealCos(xa), siderealCos(za), siderealCos(ta),
+    siderealSin(xa), siderealSin(za), siderealSin(ta));
+}
+constexpr SiderealMatrix siderealPrecessionMatrix(double mjd1900) {
+  return siderealPrecessionT(siderealPrecessionXA((mjd1900 - 36525.0) / 36525.0),
+    siderealPrecessionZA((mjd1900 - 36525.0) / 36525.0),
+    siderealPrecessionTA((mjd1900 - 36525.0) / 36525.0));
+}
+
+#endif
@@ -0,0 +1,256 @@
+/******************************************************************************
+SiderealMinorBodies.cpp
+Sidereal Planets asteroid and comet positions C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses math.h for math functions
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealMinorBodies.h"
+
+static const double GaussK = 0.01720209895;    // Gaussian gravitational constant, radians per day
+static const double Obliquity2000 = 23.43929167; // degrees, as doObliquity()
+// Newton's method doubles the good digits each step, so stopping once a step
+// is this small leaves an error of about its square.  Where double is 4
+// bytes (AVR) steps never get down to 1e-9.
+static const double KeplerTolerance = (sizeof(double) > 4) ? 1e-9 : 2e-6;
+
+// Rotate v about the x axis by angle (radians): ecliptic to equator for the obliquity
+static void rotateX(double v[3], double angle) {
+  double c = cos(angle), s = sin(angle);
+  double y = (v[1] * c) - (v[2] * s);
+  v[2] = (v[1] * s) + (v[2] * c);
+  v[1] = y;
+}
+
+// Rotate v about the z axis by angle (radians), adding angle to its longitude
+static void rotateZ(double v[3], double angle) {
+  double c = cos(angle), s = sin(angle);
+  double x = (v[0] * c) - (v[1] * s);
+  v[1] = (v[0] * s) + (v[1] * c);
+  v[0] = x;
+}
+
+// Public Methods //////////////////////////////////////////////////////////
+// Orbit orientation and size, worked out once per body.  Returns false for
+// a perihelion distance that is not positive or a negative eccentricity.
+boolean SiderealMinorBodies::calcOrbitConstants(const SiderealOrbit &orbit, SiderealOrbitConstants &constants) {
+  double q = orbit.perihelionDistance;
+  double e = orbit.eccentricity;
+  if (!(q > 0.) || !(e >= 0.)) return false; //bad input
+  double w = orbit.argumentOfPerihelion * 1.745329252e-2;
+  double node = orbit.ascendingNode * 1.745329252e-2;
+  double i = orbit.inclination * 1.745329252e-2;
+  double cosW = cos(w), sinW = sin(w);
+  double cosNode = cos(node), sinNode = sin(node);
+  double cosI = cos(i), sinI = sin(i);
+  constants.px = (cosW * cosNode) - (sinW * sinNode * cosI);
+  constants.py = (cosW * sinNode) + (sinW * cosNode * cosI);
+  constants.pz = sinW * sinI;
+  constants.qx = -(sinW * cosNode) - (cosW * sinNode * cosI);
+  constants.qy = -(sinW * sinNode) + (cosW * cosNode * cosI);
+  constants.qz = cosW * sinI;
+  constants.perihelionEpoch = orbit.perihelionEpoch;
+  constants.eccentricity = e;
+  if (e == 1.) {
+    // Barker's equation: s^3 + 3s = meanMotion * (t - T), with s = tan(v / 2)
+    constants.meanMotion = 3. * GaussK / sqrt(2. * q * q * q);
+    constants.semiMajorAxis = q;
+    constants.semiMinorAxis = 2. * q;
+  } else {
+    double a = q / fabs(1. - e);
+    constants.meanMotion = GaussK / (a * sqrt(a));
+    constants.semiMajorAxis = a;
+    constants.semiMinorAxis = a * sqrt(fabs(1. - (e * e)));
+  }
+  return true;
+}
+
+// Elements in the form the Minor Planet Center gives for asteroids: the mean
+// anomaly (degrees) at epoch, and the semi-major axis (AU).  Ellipses only.
+boolean SiderealMinorBodies::calcOrbitFromMeanAnomaly(double epoch, double meanAnomaly, double semiMajorAxis,
+    double eccentricity, double inclination, double ascendingNode, double argumentOfPerihelion,
+    SiderealOrbit &orbit) {
+  if (!(semiMajorAxis > 0.) || !(eccentricity >= 0. && eccentricity < 1.)) return false; //bad input
+  double n = GaussK / (semiMajorAxis * sqrt(semiMajorAxis));
+  double m = fmod(meanAnomaly, 360.);
+  if (m > 180.) m -= 360.;
+  if (m < -180.) m += 360.;
+  orbit.perihelionEpoch = epoch - (m * 1.745329252e-2 / n);
+  orbit.perihelionDistance = semiMajorAxis * (1. - eccentricity);
+  orbit.eccentricity = eccentricity;
+  orbit.inclination = inclination;
+  orbit.ascendingNode = ascendingNode;
+  orbit.argumentOfPerihelion = argumentOfPerihelion;
+  return true;
+}
+
+// Everything shared by all bodies, at the time, site and accuracy tier set
+// in astro.  Call again after changing any of those.  This runs doSun(), so
+// astro is left holding the Sun's position.  doPositions() only reads what
+// is set here, so threads may share one object once begin() has returned.
+boolean SiderealMinorBodies::begin(SiderealPlanets &astro) {
+  astro.doSun(); // Earth's position, nutation and obliquity of date
+  epoch = astro.getGMTepoch();
+  passes = (astro.getAccuracy() == SP_ACCURACY_FULL) ? 2 : 1;
+  double nutation = astro.getDP() * 1.745329252e-2;
+  double trueObliquity = astro.doObliquity() * 1.745329252e-2;
+  double meanObliquity = trueObliquity - (astro.getDO() * 1.745329252e-2);
+  SiderealMatrix precession = siderealPrecessionMatrix(epoch);
+  // Each column is an axis of the ecliptic of 2000.0, taken to the equator of
+  // 2000.0, precessed to the mean equator of date, then to the ecliptic of
+  // date, moved by the nutation in longitude, and back to the true equator
+  for (int j = 0; j < 3; j++) {
+    double v[3] = {0., 0., 0.};
+    double w[3];
+    v[j] = 1.;
+    rotateX(v, Obliquity2000 * 1.745329252e-2);
+    for (int i = 0; i < 3; i++) {
+      w[i] = (precession.m[i][0] * v[0]) + (precession.m[i][1] * v[1]) + (precession.m[i][2] * v[2]);
+    }
+    rotateX(w, -meanObliquity);
+    rotateZ(w, nutation);
+    rotateX(w, trueObliquity);
+    for (int i = 0; i < 3; i++) rotation[i][j] = w[i];
+  }
+  // The Earth is on the ecliptic of date, and moves at right angles to the
+  // Sun; the aberration constant is its speed over the speed of light
+  double longitude = astro.getEarthHelioLong() * 1.745329252e-2;
+  double radius = astro.getEarthRadiusVec();
+  earth[0] = radius * cos(longitude);
+  earth[1] = radius * sin(longitude);
+  earth[2] = 0.;
+  aberration[0] = -9.9387e-5 * sin(longitude);
+  aberration[1] = 9.9387e-5 * cos(longitude);
+  aberration[2] = 0.;
+  rotateZ(earth, nutation);
+  rotateX(earth, trueObliquity);
+  rotateZ(aberration, nutation);
+  rotateX(aberration, trueObliquity);
+  double lst = astro.getLocalSiderealTime() * 2.617993878e-1;
+  sinLST = sin(lst);
+  cosLST = cos(lst);
+  sinLat = sin(astro.getLatitude() * 1.745329252e-2);
+  cosLat = cos(astro.getLatitude() * 1.745329252e-2);
+  ready = true;
+  return true;
+}
+
+// Geocentric RA/Dec (hours, degrees) and distance (AU) of each body, with its
+// altitude and azimuth from the site, at the time given to begin().  The
+// distance is the geometric one, as getDistance() gives for a planet.
+boolean SiderealMinorBodies::doPositions(const SiderealOrbitConstants *orbits, int count, SiderealPosition *positions) {
+  if (ready == false) return false; //begin() not called
+  if (count < 0 || (count > 0 && (orbits == NULL || positions == NULL))) return false; //bad input
+  double delays[Block], anomalies[Block], x[Block], y[Block], z[Block];
+  for (int start = 0; start < count; start += Block) {
+    int n = (count - start < Block) ? count - start : Block;
+    const SiderealOrbitConstants *o = orbits + start;
+    SiderealPosition *p = positions + start;
+    for (int i = 0; i < n; i++) delays[i] = 0.;
+    for (int pass = 1; pass <= passes; pass++) {
+      // The second pass finds each body where it was when its light left,
+      // starting from the anomaly the first pass found
+      calcPlanePositions(o, n, delays, anomalies, pass > 1, x, y);
+      for (int i = 0; i < n; i++) {
+        double hx = (o[i].px * x[i]) + (o[i].qx * y[i]);
+        double hy = (o[i].py * x[i]) + (o[i].qy * y[i]);
+        double hz = (o[i].pz * x[i]) + (o[i].qz * y[i]);
+        x[i] = (rotation[0][0] * hx) + (rotation[0][1] * hy) + (rotation[0][2] * hz) - earth[0];
+        y[i] = (rotation[1][0] * hx) + (rotation[1][1] * hy) + (rotation[1][2] * hz) - earth[1];
+        z[i] = (rotation[2][0] * hx) + (rotation[2][1] * hy) + (rotation[2][2] * hz) - earth[2];
+      }
+      if (pass == 1) {
+        for (int i = 0; i < n; i++) {
+          double distance = sqrt((x[i] * x[i]) + (y[i] * y[i]) + (z[i] * z[i]));
+          p[i].distance = distance;
+          delays[i] = distance * 5.775518e-3; // light time in days
+        }
+      }
+    }
+    // Add the aberration to the unit vector, then take the hour angle and
+    // altitude/azimuth from its components, as doRAdec2AltAz() would
+    for (int i = 0; i < n; i++) {
+      double d = 1. / sqrt((x[i] * x[i]) + (y[i] * y[i]) + (z[i] * z[i]));
+      double ux = (x[i] * d) + aberration[0];
+      double uy = (y[i] * d) + aberration[1];
+      double uz = (z[i] * d) + aberration[2];
+      double rho = sqrt((ux * ux) + (uy * uy));
+      double length = sqrt((rho * rho) + (uz * uz));
+      double ra = atan2(uy, ux);
+      if (ra < 0.) ra += 2. * M_PI;
+      p[i].rightAscension = ra * 3.819718634;
+      p[i].declination = atan2(uz, rho) * 57.29577951;
+      double sinDec = uz / length, cosDec = rho / length;
+      if (rho < 1e-20) rho = 1e-20;
+      double cosHA = ((cosLST * ux) + (sinLST * uy)) / rho;
+      double sinHA = ((sinLST * ux) - (cosLST * uy)) / rho;
+      double sinAlt = (sinDec * sinLat) + (cosDec * cosLat * cosHA);
+      double az = atan2(-cosDec * sinHA, (sinDec * cosLat) - (cosDec * sinLat * cosHA));
+      if (az < 0.) az += 2. * M_PI;
+      p[i].altitude = asin(sinAlt) * 57.29577951;
+      p[i].azimuth = az * 57.29577951;
+    }
+  }
+  return true;
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+// Position of each body in the plane of its orbit (AU, x toward perihelion)
+// at the begin() time less its delay in days.  The eccentric (or hyperbolic)
+// anomaly found is kept, and if warm is true it is the starting value.
+void SiderealMinorBodies::calcPlanePositions(const SiderealOrbitConstants *orbits, int count, const double *delays,
+    double *anomalies, boolean warm, double *x, double *y) {
+  for (int i = 0; i < count; i++) {
+    const SiderealOrbitConstants &o = orbits[i];
+    double e = o.eccentricity;
+    double m = o.meanMotion * (epoch - delays[i] - o.perihelionEpoch);
+    if (e < 1.) {
+      // Kepler's equation by Newton's method, from Danby's starting value
+      m = fmod(m, 2. * M_PI);
+      if (m > M_PI) m -= 2. * M_PI;
+      if (m < -M_PI) m += 2. * M_PI;
+      double E = warm ? anomalies[i] : m + ((sin(m) < 0.) ? -0.85 : 0.85) * e;
+      double s = 0., c = 1., d = 0.;
+      for (int k = 0; k < 30; k++) {
+        s = sin(E);
+        c = cos(E);
+        d = (E - (e * s) - m) / (1. - (e * c));
+        E -= d;
+        if (fabs(d) < KeplerTolerance) break;
+      }
+      // sin and cos of the last E, to within d squared
+      anomalies[i] = E;
+      x[i] = o.semiMajorAxis * (c + (s * d) - e);
+      y[i] = o.semiMinorAxis * (s - (c * d));
+    } else if (e > 1.) {
+      // The hyperbolic form, e sinh(H) - H = m
+      double H = warm ? anomalies[i] : (m < 0.) ? -log((-2. * m / e) + 1.8) : log((2. * m / e) + 1.8);
+      for (int k = 0; k < 50; k++) {
+        double d = ((e * sinh(H)) - H - m) / ((e * cosh(H)) - 1.);
+        H -= d;
+        if (fabs(d) < KeplerTolerance) break;
+      }
+      anomalies[i] = H;
+      x[i] = o.semiMajorAxis * (e - cosh(H));
+      y[i] = o.semiMinorAxis * sinh(H);
+    } else {
+      // Barker's equation has the closed form s = 2 sinh(asinh(m / 2) / 3).
+      // avr-libc has no asinh(), so take log(u + sqrt(u u + 1)) of |m / 2|,
+      // which also avoids cancellation for large negative m.
+      double u = fabs(m / 2.);
+      double a = log(u + sqrt((u * u) + 1.)) / 3.;
+      double s = 2. * sinh((m < 0.) ? -a : a);
+      x[i] = o.semiMajorAxis * (1. - (s * s));
+      y[i] = o.semiMinorAxis * s;
+    }
+  }
+}
@@ -0,0 +1,92 @@
+/******************************************************************************
+SiderealMinorBodies.h
+Sidereal Planets asteroid and comet positions Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealMinorBodies class, as implemented in SiderealMinorBodies.cpp
+
+Works out geocentric RA/Dec and distance of any number of asteroids and
+comets from their osculating orbital elements, such as those published by
+the Minor Planet Center, at the time set in a SiderealPlanets object.
+
+Everything that does not depend on the body is done once per time by
+begin(): the Sun and the Earth's position, the precession from 2000.0,
+nutation and the Earth's velocity for aberration are all folded into one
+rotation and two vectors.  Each body's orbit orientation is worked out once
+by calcOrbitConstants(), as two unit vectors.  A body then costs one
+solution of Kepler's equation per light-time pass (the second pass starts
+from the first one's answer, so it takes one or two steps), two small
+matrix products, and four inverse trig functions for RA/Dec and
+altitude/azimuth.  Bodies are done in blocks, one stage at a time: Kepler's
+equation for the whole block, then the rotations for the whole block, so
+each loop is small and the rotation loops have no branches.
+
+Positions follow doPlans(): the orbit is unperturbed, light time is allowed
+for (in SP_ACCURACY_FULL), and nutation and annual aberration are applied as
+the accuracy tier of the SiderealPlanets object gives them.  Positions are
+geocentric; doTopocentricSites() corrects them for parallax, which matters
+for bodies that pass near the Earth.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealMinorBodies_h
+#define __SiderealMinorBodies_h
+
+#include "SiderealPlanets.h"
+
+// Orbital elements of an asteroid or comet.  Angles are in degrees, referred
+// to the ecliptic and equinox of 2000.0.  Eccentricity is under 1 for an
+// ellipse, 1 for a parabola and over 1 for a hyperbola.
+struct SiderealOrbit {
+  double perihelionEpoch;      // time of perihelion, days since 1900 January 0.5 GMT
+  double perihelionDistance;   // AU
+  double eccentricity;
+  double inclination;
+  double ascendingNode;
+  double argumentOfPerihelion;
+};
+
+// Orbit terms from calcOrbitConstants()
+struct SiderealOrbitConstants {
+  double px, py, pz;           // unit vector toward perihelion, ecliptic 2000.0
+  double qx, qy, qz;           // unit vector 90 degrees on along the orbit
+  double perihelionEpoch;
+  double eccentricity;
+  double meanMotion;           // radians per day; for a parabola, of Barker's equation
+  double semiMajorAxis;        // AU, positive for a hyperbola too; q for a parabola
+  double semiMinorAxis;        // AU; 2q for a parabola
+};
+
+class SiderealMinorBodies {
+  public:
+    static boolean calcOrbitConstants(const SiderealOrbit &orbit, SiderealOrbitConstants &constants);
+    static boolean calcOrbitFromMeanAnomaly(double epoch, double meanAnomaly, double semiMajorAxis,
+      double eccentricity, double inclination, double ascendingNode, double argumentOfPerihelion,
+      SiderealOrbit &orbit);
+    boolean begin(SiderealPlanets &astro);
+    boolean doPositions(const SiderealOrbitConstants *orbits, int count, SiderealPosition *positions);
+
+  private:
+#ifdef SIDEREAL_PLANETS_HOST
+    static const int Block = 64;
+#else
+    static const int Block = 4;     // keeps the stack small on an AVR
+#endif
+    boolean ready = false;
+    double epoch = 0.;
+    int passes = 2;                 // 2 allows for light time
+    double rotation[3][3];          // ecliptic 2000.0 to true equator of date
+    double earth[3];                // heliocentric Earth, true equator of date, AU
+    double aberration[3];           // Earth's velocity over the speed of light
+    double sinLST = 0., cosLST = 1.;
+    double sinLat = 0., cosLat = 1.;
+
+    void calcPlanePositions(const SiderealOrbitConstants *orbits, int count, const double *delays,
+      double *anomalies, boolean warm, double *x, double *y);
+};
+#endif
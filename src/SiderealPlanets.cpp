@@ -25,6 +25,9 @@ Distributed as-is; no warranty is given.
 #define Serial SERIAL_PORT_USBVIRTUAL
 #endif
 
+// Days in each month, with the leap year months starting at index 13
+const byte SiderealPlanets::monthDays[25] PROGMEM = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
 // Public Methods //////////////////////////////////////////////////////////
 // Start by doing any setup, and verifying that doubles are supported
 boolean SiderealPlanets::begin(void) {
@@ -34,11 +37,21 @@ boolean SiderealPlanets::begin(void) {
 
   DSToffset = 0; // GMT is default
   TimeZoneOffset = 0.0;
+  GMTyear = 2000; // Until setGMTdate() and setGMTtime() are called
+  GMTmonth = 1;
+  GMTday = 1;
+  GMThour = 0;
+  GMTminute = 0;
+  GMTseconds = 0.0;
   decLat = 51.178889; // Default in decimal Degrees
   decLong = -1.826111;
+  radLat = deg2rad(decLat);
+  cosLat = cos(radLat);
+  sinLat = sin(radLat);
+  seaLevelHeightMeters = 0.;
+  doSiteConstants();
   autoDST = false;
   useDST = false;
-  leapYear = false;
   DstSelected = false;
   GmtDateInput = false;
   GmtTimeInput = false;
@@ -50,6 +63,9 @@ boolean SiderealPlanets::begin(void) {
   risetDone = false;
   doMoonDone = false;
   getLunarLuminanceDone = false;
+  lastBody = SP_SUN;
+  accuracy = SP_ACCURACY_FULL;
+  dstRule = SP_DST_US;
   return true;
 }
 
@@ -108,124 +124,76 @@ void SiderealPlanets::rejectDST(void) {
   DSToffset = 0;
 }
 
-void SiderealPlanets::doAutoDST(void) {
-  if (GmtTimeInput && GmtDateInput && DstSelected && autoDST)
-    calcLocalHour( GMTyear, (byte)GMTmonth, (byte)GMTday, (byte)GMThour, (byte)TimeZoneOffset);
+// Select automatic DST with another rule, such as SP_DST_EU
+boolean SiderealPlanets::useAutoDST(const SiderealDSTRule &rule) {
+  dstRule = rule;
+  return useAutoDST();
 }
 
-// See https://github.com/nseidle/Daylight_Savings_Time_Example
-//Given a year/month/day/current UTC/local offset give me local time
-byte SiderealPlanets::calcLocalHour(int year, byte month, byte day, byte hour, byte local_hour_offset)
-{
-  //Since 2007 DST starts on the second Sunday in March and ends the first Sunday of November
-  //Let's just assume it's going to be this way for awhile (silly US government!)
-  //Example from: http://stackoverflow.com/questions/5590429/calculating-daylight-savings-time-from-only-date
-
-  byte DoW = day_of_week(year, month, day); //Get the day of the week. 0 = Sunday, 6 = Saturday
-  int previousSunday = day - DoW;
-
-  boolean dst = false; //Assume we're not in DST
-  if(month > 3 && month < 11) dst = true; //DST is happening!
-
-  //In March, we are DST if our previous Sunday was on or after the 8th.
-  if (month == 3)
-  {
-    if(previousSunday >= 8) dst = true; 
-  } 
-  //In November we must be before the first Sunday to be dst.
-  //That means the previous Sunday must be before the 1st.
-  if(month == 11)
-  {
-    if(previousSunday <= 0) dst = true;
+// DST starts and ends at an instant (2 a.m. local time in the US), not at
+// the start of a GMT day, so compare the current GMT instant with both
+void SiderealPlanets::doAutoDST(void) {
+  if (!(GmtTimeInput && GmtDateInput && DstSelected && autoDST)) return;
+  double start, end;
+  boolean dst = false;
+  if (calcDSTtransitions(GMTyear, TimeZoneOffset, dstRule, start, end)) {
+    double now = modifiedJulianDate1900() + (GMTtime / 24.0);
+    if (start < end)
+      dst = (now >= start && now < end);
+    else
+      dst = (now >= start || now < end); // Southern hemisphere
   }
-  
-  if(dst == true) hour++;
-
-  //Convert UTC hours to local current time using local_hour
-  if(hour < local_hour_offset)
-    hour += 24; //Add 24 hours before subtracting local offset
-  hour -= local_hour_offset;
-  if(hour > 12) hour -= 12; //Get rid of military time
-  
-  /*
-  Serial.print("Hour: ");
-  Serial.println(hour);
-  Serial.print("Day of week: ");
-  if(DoW == 0) Serial.println("Sunday");
-  if(DoW == 1) Serial.println("Monday");
-  if(DoW == 2) Serial.println("Tuesday");
-  if(DoW == 3) Serial.println("Wednesday");
-  if(DoW == 4) Serial.println("Thursday");
-  if(DoW == 5) Serial.println("Friday!");
-  if(DoW == 6) Serial.println("Saturday");
-  */
   useDST = dst; //set the flag that we are using it or not
-  if (autoDST) {
-    if (dst == true)
-	  DSToffset = 1; // this is the one hour difference
-    else
-      DSToffset = 0;
+  if (dst == true)
+    DSToffset = dstRule.amount; // usually one hour, but half an hour in some places
+  else
+    DSToffset = 0;
+}
+
+// GMT epochs (days since 1900 January 0.5) when DST starts and ends in a year.
+// Returns false if the rule has no DST.
+boolean SiderealPlanets::calcDSTtransitions(int year, float zone, const SiderealDSTRule &rule, double &start, double &end) {
+  if (rule.startMonth < 1 || rule.startMonth > 12 || rule.endMonth < 1 || rule.endMonth > 12) return false;
+  double startGMT = rule.startHour;
+  double endGMT = rule.endHour;
+  if (rule.utcSwitch == false) {
+    startGMT -= zone;             // switch given in local standard time
+    endGMT -= zone + rule.amount; // switch given in local daylight time
   }
-  return(hour);
+  // Add the hours as one term, so a switch lands exactly on GMTtime / 24
+  start = calcRuleDay(year, rule.startMonth, rule.startWeek, rule.startDayOfWeek) + (startGMT / 24.0);
+  end = calcRuleDay(year, rule.endMonth, rule.endWeek, rule.endDayOfWeek) + (endGMT / 24.0);
+  return true;
 }
 
 //Given the current year/month/day
 //Returns 0 (Sunday) through 6 (Saturday) for the day of the week
-//From: http://en.wikipedia.org/wiki/Calculating_the_day_of_the_week
 //This function assumes the month from the caller is 1-12
 char SiderealPlanets::day_of_week(int year, int month, int day)
 {
-  //Devised by Tomohiko Sakamoto in 1993, it is accurate for any Gregorian date:
-  static int t[] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4  };
-  year -= month < 3;
-  return (year + year/4 - year/100 + year/400 + t[month-1] + day) % 7;
+  return siderealDayOfWeek(year, month, day);
+}
+
+// Epoch at 0h GMT of the week'th dayOfWeek (0 = Sunday) of a month.
+// A week of 5 or more means the last one in the month.
+double SiderealPlanets::calcRuleDay(int year, byte month, byte week, byte dayOfWeek) {
+  int first = day_of_week(year, month, 1);
+  int day = 1 + ((dayOfWeek - first + 7) % 7);
+  if (week >= 5) {
+    int days = (month == 12) ? 31 : (int)(siderealMJD1900(year, month + 1, 1) - siderealMJD1900(year, month, 1));
+    while (day + 7 <= days) day += 7;
+  } else if (week > 1) {
+    day += 7 * (week - 1);
+  }
+  return siderealMJD1900(year, month, day);
 }
 
 double SiderealPlanets::modifiedJulianDate1900(void) {
   // Based on Year 1900
   if (MJDdone) return mjd1900;
-  int y1 = GMTyear;
-  long m1 = GMTmonth;
-  long b = 0;
-  boolean doextra = false;
-  if (y1 < 1) y1 += 1; //Account for there being no year zero
-  if (GMTmonth < 3) {
-	m1 =  GMTmonth + 12;
-	y1 -= 1;
-  }
-  if (y1 > 1582) {
-	doextra = true;
-  } else {
-	if (y1 < 1582) {
-      doextra = false;
-	} else {
-      if (y1 == 1582 && GMTmonth < 10) {
-        doextra = false;
-	  } else {
-        if ((y1 == 1582 && GMTmonth == 10 && GMTday < 5)) {
-          doextra = false;
-		} else {
-          if (GMTmonth > 10 || GMTday > 14) {
-            doextra = true;
-		  } else {
-            return -9999999.; //not allowed
-		  }
-		}
-	  }
-	}
-  }
-  if (doextra) {
-	long a = y1 / 100;
-	b = 2 - a + (a / 4);
-  }
-  long c = (365.25 * (double)y1);
-  c -= 694025;
-  if (y1 < 0) {
-    c = (365.25 * y1) - 0.75;
-	c -= 694025;
-  }
-  long d = (30.6001 * (m1 + 1));
-  mjd1900 = b + c + d + GMTday - 0.5;
+  double mjd = siderealMJD1900(GMTyear, GMTmonth, GMTday);
+  if (mjd == -9999999.) return mjd; //not allowed
+  mjd1900 = mjd;
   MJDdone = true;
   return mjd1900;
 }
@@ -238,9 +206,9 @@ boolean SiderealPlanets::setLatLong(double latitude, double longitude) {
   decLat = latitude;
   radLat = deg2rad(decLat);
   decLong = longitude;
-  radLong = deg2rad(decLong);
   cosLat = cos(radLat);
   sinLat = sin(radLat);
+  doSiteConstants();
   risetDone = false;
   return true;
 }
@@ -249,6 +217,7 @@ boolean SiderealPlanets::setGMTdate(int year, int month, int day) {
   if (GMTyear == year && GMTmonth == month && GMTday == day) return true; //Already did it
   if (year == 0) return false;
   GMTyear = year;
+  boolean leapYear;
   // Is this a leap year?
   if (year % 4 == 0) {
     if (year % 100 == 0) {
@@ -270,19 +239,17 @@ boolean SiderealPlanets::setGMTdate(int year, int month, int day) {
   if (day < 1 or day > 31) {
 	return false;
   } else {
-	if (leapYear)
-      if (monthDays[month + 12] < day) return false;
-    else
-      if (monthDays[month] < day) return false;
+	if (leapYear) month += 12;
+    if (pgm_read_byte(&monthDays[month]) < day) return false;
     GMTday = day;
   }
   GmtDateInput = true;
-  doAutoDST();
   MJDdone = false;
   precessArrayDone = false;
   obliquityDone = false;
   nutationDone = false;
   Ecl2RaDecDone = false;
+  doAutoDST();
   return true;
 }
 
@@ -297,8 +264,8 @@ boolean SiderealPlanets::setGMTtime(int hours, int minutes, float seconds) {
   GMTminute = minutes;
   GMTseconds = seconds;
   GmtTimeInput = true;
-  doAutoDST();
   GMTtime = GMThour + (GMTminute / 60.0) + (GMTseconds / 3600.0);
+  doAutoDST();
   return true;
 }
 
@@ -312,9 +279,71 @@ boolean SiderealPlanets::setLocalTime(int hours, int minutes, float seconds) {
   if (minutes < 0 || minutes > 59) return false;
   if (seconds < 0. || seconds > 59.999999999) return false;
   // if doAutoDST was set to do, we just did it anyway
-  GMThour = hours - TimeZoneOffset;
-  if (useDST) GMThour -= 1;
-  return setGMTtime(inRange24(GMThour), minutes, seconds);
+  int hourGMT = hours - TimeZoneOffset;
+  if (useDST) { // DSToffset may be a half hour
+    int minuteGMT = (((hourGMT * 60) + minutes - (int)round(DSToffset * 60)) % 1440 + 1440) % 1440;
+    hourGMT = minuteGMT / 60;
+    minutes = minuteGMT % 60;
+  }
+  return setGMTtime(inRange24(hourGMT), minutes, seconds);
+}
+
+// Set the GMT date and time from an epoch in days since 1900 January 0.5,
+// the same count as modifiedJulianDate1900() + getGMT() / 24.
+boolean SiderealPlanets::setGMTepoch(double epoch) {
+  double day = floor(epoch + 0.5);
+  return setGMTday((long)day, epoch + 0.5 - day);
+}
+
+// Julian Date as a whole day number plus a fraction, to keep full precision
+boolean SiderealPlanets::setJulianDate(long day, double fraction) {
+  return setGMTday(day - 2415020L, fraction + 0.5);
+}
+
+// Modified Julian Date (JD - 2400000.5) as a whole day number plus a fraction
+boolean SiderealPlanets::setMJD(long day, double fraction) {
+  return setGMTday(day - 15019L, fraction);
+}
+
+// Unix time: seconds since 1970 January 1, 0h GMT, plus a fraction of a second
+boolean SiderealPlanets::setUnixTime(int64_t seconds, double fraction) {
+  int64_t day = seconds / 86400;
+  int64_t rest = seconds - (day * 86400);
+  if (rest < 0) {
+    rest += 86400;
+    day -= 1;
+  }
+  return setGMTday((long)day + 25568L, (rest + fraction) / 86400.);
+}
+
+double SiderealPlanets::getGMTepoch(void) {
+  return modifiedJulianDate1900() + (GMTtime / 24.0);
+}
+
+// Convert arrays of timestamps to epochs (days since 1900 January 0.5 GMT).
+// Plain arithmetic with no branches, so the compiler can vectorize the loops.
+boolean SiderealPlanets::calcEpochsFromUnix(const int64_t *seconds, double *epochs, int count) {
+  if (seconds == NULL || epochs == NULL) return false;
+  for (int i = 0; i < count; i++) {
+    epochs[i] = ((double)seconds[i] / 86400.) + 25567.5;
+  }
+  return true;
+}
+
+boolean SiderealPlanets::calcEpochsFromJD(const double *julianDates, double *epochs, int count) {
+  if (julianDates == NULL || epochs == NULL) return false;
+  for (int i = 0; i < count; i++) {
+    epochs[i] = julianDates[i] - 2415020.;
+  }
+  return true;
+}
+
+boolean SiderealPlanets::calcEpochsFromMJD(const double *modifiedJulianDates, double *epochs, int count) {
+  if (modifiedJulianDates == NULL || epochs == NULL) return false;
+  for (int i = 0; i < count; i++) {
+    epochs[i] = modifiedJulianDates[i] - 15019.5;
+  }
+  return true;
 }
 
 double SiderealPlanets::getLatitude(void) {
@@ -331,34 +360,21 @@ double SiderealPlanets::getGMT(void) {
 
 double SiderealPlanets::getLT(void) {
   double localStandardTime = GMTtime + TimeZoneOffset;
-  if (useDST) localStandardTime += 1;
+  if (useDST) localStandardTime += DSToffset;
   return inRange24(localStandardTime);
 }
 
 double SiderealPlanets::getLocalSiderealTime(void) {
-  LocalSiderealTime = inRange24(getGMTsiderealTime() + (decLong / 15.0));
-  return LocalSiderealTime;
+  return inRange24(getGMTsiderealTime() + (decLong / 15.0));
 }
 
 double SiderealPlanets::getGMTsiderealTime(void) {
-  modifiedJulianDate1900();
-  double days = ((long)(mjd1900 - 0.5)) + 0.5;
-  double t = (days / 36525.0) - 1.;
-  double r0 = t * (5.13366e-2 + (t * (2.586222e-5 - (t * 1.722e-9))));
-  double r1 = 6.697374558 + (2400.0 * (t - ((GMTyear - 2000.0) / 100.0)));
-  double t0 = inRange24(r0 + r1);
-  GMTsiderealTime = inRange24((GMTtime * 1.002737908) + t0);
-  return GMTsiderealTime;
+  return siderealGMST(modifiedJulianDate1900(), GMTyear, GMTtime);
 }
 
 double SiderealPlanets::doLST2LT(double localSiderealTime) {
   //for computing rise/set times
-  modifiedJulianDate1900();
-  double days = ((long)(mjd1900 - 0.5)) + 0.5;
-  double t = (days / 36525.0) - 1.;
-  double r0 = t * (5.13366e-2 + (t * (2.586222e-5 - (t * 1.722e-9))));
-  double r1 = 6.697374558 + (2400.0 * (t - ((GMTyear - 2000.0) / 100.0)));
-  double t0 = inRange24(r0 + r1);
+  double t0 = siderealGST0(modifiedJulianDate1900(), GMTyear);
   double julianCenturies1900 = inRange24(t0 - (DSToffset + TimeZoneOffset) * 1.002737908);
   double GSTdecimalhours = inRange24(localSiderealTime - (decLong / 15.0));
   if (GSTdecimalhours < julianCenturies1900) GSTdecimalhours += 24.;
@@ -372,42 +388,36 @@ double SiderealPlanets::doLST2GMT(double localSiderealTime) {
 }
 
 boolean SiderealPlanets::setElevationM(double height) {
+  if (seaLevelHeightMeters == height) return true; //Already did it
   seaLevelHeightMeters = height;
+  doSiteConstants();
   return true;
 }
 
 boolean SiderealPlanets::setElevationF(double height) {
-  seaLevelHeightMeters = height / 3.2808;
-  return true;
+  return setElevationM(height / 3.2808);
 }
 
+// Reduce an angle to [0, 24) hours, [0, 360) degrees or [0, 2 PI) radians.
+// fmod() is exact, and takes the same time for any size of angle.
 double SiderealPlanets::inRange24(double d) {
-  while (d < 0.) {
-	d += 24.;
-  }
-  while (d >= 24.) {
-	d -= 24.;
-  }
+  d = fmod(d, 24.);
+  if (d < 0.) d += 24.;
+  if (d >= 24.) d -= 24.; // a tiny negative d can round up to 24
   return d;
 }
 
 double SiderealPlanets::inRange360(double d) {
-  while (d < 0.) {
-	d += 360.;
-  }
-  while (d >= 360.) {
-	d -= 360.;
-  }
+  d = fmod(d, 360.);
+  if (d < 0.) d += 360.;
+  if (d >= 360.) d -= 360.; // a tiny negative d can round up to 360
   return d;
 }
 
 double SiderealPlanets::inRange2PI(double d) {
-  while (d < 0.) {
-	d += F2PI;
-  }
-  while (d >= F2PI) {
-	d -= F2PI;
-  }
+  d = fmod(d, F2PI);
+  if (d < 0.) d += F2PI;
+  if (d >= F2PI) d -= F2PI; // a tiny negative d can round up to F2PI
   return d;
 }
 
@@ -528,19 +538,25 @@ boolean SiderealPlanets::doNutation(void) {
   N1_local = deg2rad(N1_local);
   double N2_local = 2. * N1_local;
   
-  nutationInLongitude = (-17.2327 - 1.737e-2 * t) * sin(N1_local);
-  nutationInLongitude = nutationInLongitude + (-1.2729 - 1.3e-4 * t) * sin(L2_local) + 2.088e-1 * sin(N2_local);
-  nutationInLongitude = nutationInLongitude - 2.037e-1 * sin(d2) + (1.261e-1 - 3.1e-4 * t) * sin(M1_local);
-  nutationInLongitude = nutationInLongitude + 6.75E-2 * sin(M2_local) - (4.97e-2 - 1.2e-4 * t) * sin(L2_local + M1_local);
-  nutationInLongitude = nutationInLongitude - 3.42e-2 * sin(d2 - N1_local) - 2.61e-2 * sin(d2 + M2_local);
-  nutationInLongitude = nutationInLongitude + 2.14e-2 * sin(L2_local - M1_local) - 1.49e-2 * sin(L2_local - d2 + M2_local);
-  nutationInLongitude = nutationInLongitude + 1.24E-2 * sin(L2_local - N1_local) + 1.14e-2 * sin(d2 - M2_local);
-  
-  nutationInObliquity = (9.21 + 9.1E-4 * t) * cos(N1_local);
-  nutationInObliquity = nutationInObliquity + (5.522e-1 - 2.9e-4 * t) * cos(L2_local) - 9.04e-2 * cos(N2_local);
-  nutationInObliquity = nutationInObliquity + 8.84e-2 * cos(d2) + 2.16e-2 * cos(L2_local + M1_local);
-  nutationInObliquity = nutationInObliquity + 1.83e-2 * cos(d2 - N1_local) + 1.13e-2 * cos(d2 + M2_local);
-  nutationInObliquity = nutationInObliquity + 9.3e-3 * cos(L2_local - M1_local) - 6.6e-3 * cos(L2_local - N1_local);
+  // The 18.6 year term is 17 arc seconds; the rest are under 1.3
+  nutationInLongitude = 0.;
+  nutationInObliquity = 0.;
+  if (accuracy != SP_ACCURACY_DEGREE) {
+    nutationInLongitude = (-17.2327 - 1.737e-2 * t) * sin(N1_local);
+    nutationInObliquity = (9.21 + 9.1E-4 * t) * cos(N1_local);
+  }
+  if (accuracy == SP_ACCURACY_FULL) {
+    nutationInLongitude = nutationInLongitude + (-1.2729 - 1.3e-4 * t) * sin(L2_local) + 2.088e-1 * sin(N2_local);
+    nutationInLongitude = nutationInLongitude - 2.037e-1 * sin(d2) + (1.261e-1 - 3.1e-4 * t) * sin(M1_local);
+    nutationInLongitude = nutationInLongitude + 6.75E-2 * sin(M2_local) - (4.97e-2 - 1.2e-4 * t) * sin(L2_local + M1_local);
+    nutationInLongitude = nutationInLongitude - 3.42e-2 * sin(d2 - N1_local) - 2.61e-2 * sin(d2 + M2_local);
+    nutationInLongitude = nutationInLongitude + 2.14e-2 * sin(L2_local - M1_local) - 1.49e-2 * sin(L2_local - d2 + M2_local);
+    nutationInLongitude = nutationInLongitude + 1.24E-2 * sin(L2_local - N1_local) + 1.14e-2 * sin(d2 - M2_local);
+    nutationInObliquity = nutationInObliquity + (5.522e-1 - 2.9e-4 * t) * cos(L2_local) - 9.04e-2 * cos(N2_local);
+    nutationInObliquity = nutationInObliquity + 8.84e-2 * cos(d2) + 2.16e-2 * cos(L2_local + M1_local);
+    nutationInObliquity = nutationInObliquity + 1.83e-2 * cos(d2 - N1_local) + 1.13e-2 * cos(d2 + M2_local);
+    nutationInObliquity = nutationInObliquity + 9.3e-3 * cos(L2_local - M1_local) - 6.6e-3 * cos(L2_local - N1_local);
+  }
   
   nutationInLongitude = nutationInLongitude / 3600.0;
   nutationInObliquity = nutationInObliquity / 3600.0;
@@ -613,6 +629,7 @@ boolean SiderealPlanets::doEcliptic2RAdec(void) {
   return true;
 }
 
+#ifndef SIDEREAL_PLANETS_NO_PRECESSION
 boolean SiderealPlanets::doPrecessFrom2000(void) {
   doPrecessArray();
   // convert input to column vector
@@ -621,11 +638,11 @@ boolean SiderealPlanets::doPrecessFrom2000(void) {
   cv[1] = cosRA * cosDec;
   cv[2] = sinRA * cosDec;
   cv[3] = sinDec;
-  // multiply otherPrecessionMatrix by cv
+  // multiply the transpose of precessionMatrix by cv
   for(j = 1; j < 4; j++) {
     sm = 0.0;
 	for(i = 1; i < 4; i++) {
-      sm += otherPrecessionMatrix[i][j] * cv[i];
+      sm += precessionMatrix.m[j - 1][i - 1] * cv[i];
 	}
 	hl[j] = sm;
   }
@@ -658,7 +675,7 @@ boolean SiderealPlanets::doPrecessTo2000(void) {
   for(j = 1; j < 4; j++) {
     sm = 0.0;
 	for(i = 1; i < 4; i++) {
-      sm += precessionMatrix[i][j] * cv[i];
+      sm += precessionMatrix.m[i - 1][j - 1] * cv[i];
 	}
 	hl[j] = sm;
   }
@@ -683,91 +700,360 @@ boolean SiderealPlanets::doPrecessArray(void) {
   if (precessArrayDone == false) {
     //t = julian centuries since 2000 jan 1.5
     double t = (modifiedJulianDate1900() - 36525.0) / 36525.0;
-	// Generate parameters for matrix elements
-    double xa = (((0.000005 * t) + 0.0000839) * t + 0.6406161) * t;
-    double za = (((0.0000051 * t) + 0.0003041) * t + 0.6406161) * t;
-    double ta = (((-0.0000116 * t) - 0.0001185) * t + 0.556753) * t;
-    xa = deg2rad(xa);
-    za = deg2rad(za);
-    ta = deg2rad(ta);
-    double c1 = cos(xa);
-    double c2 = cos(za);
-    double c3 = cos(ta);
-    double s1 = sin(xa);
-    double s2 = sin(za);
-    double s3 = sin(ta);
-    // Generate matrix elements for the two matrixies needed
-    precessionMatrix[1][1] = c1 * c3 * c2 - s1 * s2;
-	otherPrecessionMatrix[1][1] = precessionMatrix[1][1];
-    precessionMatrix[1][2] = -s1 * c3 * c2 - c1 * s2;
-	otherPrecessionMatrix[2][1] = precessionMatrix[1][2];
-    precessionMatrix[1][3] = -s3 * c2;
-	otherPrecessionMatrix[3][1] = precessionMatrix[1][3];
-    precessionMatrix[2][1] = c1 * c3 * s2 + s1 * c2;
-	otherPrecessionMatrix[1][2] = precessionMatrix[2][1];
-    precessionMatrix[2][2] = -s1 * c3 * s2 + c1 * c2;
-	otherPrecessionMatrix[2][2] = precessionMatrix[2][2];
-    precessionMatrix[2][3] = -s3 * s2;
-	otherPrecessionMatrix[3][2] = precessionMatrix[2][3];
-    precessionMatrix[3][1] = c1 * s3;
-	otherPrecessionMatrix[1][3] = precessionMatrix[3][1];
-    precessionMatrix[3][2] = -s1 * s3;
-	otherPrecessionMatrix[2][3] = precessionMatrix[3][2];
-    precessionMatrix[3][3] = c3;
-	otherPrecessionMatrix[3][3] = precessionMatrix[3][3];
+    double xa = siderealPrecessionXA(t);
+    double za = siderealPrecessionZA(t);
+    double ta = siderealPrecessionTA(t);
+    // Same matrix as siderealPrecessionMatrix(), with the library sin/cos.
+    // Precessing the other way uses the transpose.
+    precessionMatrix = siderealPrecessionTrig(cos(xa), cos(za), cos(ta), sin(xa), sin(za), sin(ta));
     precessArrayDone = true;
   }
   return true;
 }
 
-boolean SiderealPlanets::doLunarParallax(void) {
-  //do on first call to this location
+#endif
+
+// Private: set the date from a day number (1 = 1900 January 1) and the time
+// from the fraction of that day.  The calendar date is only worked out when
+// the day changes, and mjd1900 is set directly instead of from the calendar.
+// Calendar conversion from Meeus, Astronomical Algorithms, chapter 7.
+boolean SiderealPlanets::setGMTday(long day, double fraction) {
+  double whole = floor(fraction);
+  day += (long)whole;
+  fraction -= whole;
+  if (!(GmtDateInput && MJDdone && mjd1900 == day - 0.5)) {
+    long z = day + 2415020L;
+    long a = z;
+    if (z >= 2299161L) {
+      long alpha = (long)((z - 1867216.25) / 36524.25);
+      a = z + 1 + alpha - (alpha / 4);
+    }
+    long b = a + 1524;
+    long c = (long)((b - 122.1) / 365.25);
+    long d = (long)(365.25 * c);
+    int e = (int)((b - d) / 30.6001);
+    int dayOfMonth = (int)(b - d - (long)(30.6001 * e));
+    int month = (e < 14) ? e - 1 : e - 13;
+    int year = (month > 2) ? (int)(c - 4716) : (int)(c - 4715);
+    if (year < 1) year -= 1; //there is no year zero
+    if (setGMTdate(year, month, dayOfMonth) == false) return false;
+    mjd1900 = day - 0.5;
+    MJDdone = true;
+  }
+  double seconds = fraction * 86400.;
+  int hours = (int)(seconds / 3600.);
+  if (hours > 23) hours = 23;
+  seconds -= hours * 3600.;
+  int minutes = (int)(seconds / 60.);
+  if (minutes > 59) minutes = 59;
+  seconds -= minutes * 60.;
+  if (seconds > 59.999) seconds = 59.999;
+  if (setGMTtime(hours, minutes, seconds) == false) return false;
+  GMTtime = fraction * 24.0; // full precision, not limited by float seconds
+  return true;
+}
+
+// Private: site terms of the parallax correction for the current site
+void SiderealPlanets::doSiteConstants(void) {
   double u = atan(9.96647e-1 * sinLat / cosLat);
-  double c2 = cos(u);
-  double s2 = sin(u);
   double ht = seaLevelHeightMeters / 6378140.0; // height in earth radii
-  double rs = (9.96647e-1 * s2) + (ht * sinLat);
-  double rc = c2 + (ht * cosLat);
-  
-  double rp = 1. / sin(deg2rad(EquatHorizontalParallax));
-  // x = Hour Angle, y = declination
-  double lst = getLocalSiderealTime();
-  double HAdec = inRange24(lst - RAdec);
-  double HArad = deg2rad(HAdec) * 15.0;
+  rhoSinLat = (9.96647e-1 * sin(u)) + (ht * sinLat);
+  rhoCosLat = cos(u) + (ht * cosLat);
+}
+
+// Private: rotation from East, North, Up at the site to equatorial x, y, z of
+// date (x toward RA 0h, z toward the pole) at the current local sidereal time
+void SiderealPlanets::calcHorizon2Equator(double matrix[3][3]) {
+  double theta = getLocalSiderealTime() * 2.617993878e-1;
+  double st = sin(theta);
+  double ct = cos(theta);
+  matrix[0][0] = -st;
+  matrix[0][1] = -ct * sinLat;
+  matrix[0][2] = ct * cosLat;
+  matrix[1][0] = ct;
+  matrix[1][1] = -st * sinLat;
+  matrix[1][2] = st * cosLat;
+  matrix[2][0] = 0.;
+  matrix[2][1] = cosLat;
+  matrix[2][2] = sinLat;
+}
+
+// Private: RA (hours, 0 to 24) and Dec (degrees) of one East, North, Up vector
+void SiderealPlanets::calcVector2RAdec(const double matrix[3][3], double east, double north, double up,
+    float &rightAscension, float &declination) {
+  // The rotation in double; float is enough for the angles and much faster
+  float x = (matrix[0][0] * east) + (matrix[0][1] * north) + (matrix[0][2] * up);
+  float y = (matrix[1][0] * east) + (matrix[1][1] * north) + (matrix[1][2] * up);
+  float z = (matrix[2][1] * north) + (matrix[2][2] * up);
+  float ra = atan2f(y, x) * 3.819718634f; // radians to hours
+  rightAscension = (ra < 0.f) ? ra + 24.f : ra;
+  declination = atan2f(z, sqrtf((x * x) + (y * y))) * 5.729577951e1f;
+}
+
+// Private: shift a geocentric position to the observer, and find its alt/az.
+// The input and output may be the same position.
+void SiderealPlanets::calcTopocentric(double localSiderealTime, const SiderealSiteConstants &site,
+    const SiderealPosition &geocentric, SiderealPosition &topocentric) {
+  double rp = geocentric.distance / 4.263523e-5; // distance in earth radii
+  double HArad = (localSiderealTime - geocentric.rightAscension) * 2.617993878e-1;
+  double decRad = geocentric.declination * 1.745329252e-2;
   double cosHA = cos(HArad);
   double sinHA = sin(HArad);
-
-  double a = (rc * sinHA) / ((rp * cosDec) - (rc * cosHA));
-  double dx = atan(a); //correction to hour angle, in radians
-  double p = HArad + dx;
+  double cosDec = cos(decRad);
+  double sinDec = sin(decRad);
+  double a = (site.rhoCosLat * sinHA) / ((rp * cosDec) - (site.rhoCosLat * cosHA));
+  double p = HArad + atan(a); // hour angle corrected for parallax
   double cp = cos(p);
-  HArad = inRange2PI(p);
-  DeclinationRad = atan(cp * (rp * sinDec - rs) / (rp * cosDec * cosHA - rc));
-  // Also update the 'other' internal stuff here
-  HAdec = rad2deg(HArad) / 15.;
-  RAdec = inRange24(lst - HAdec);
+  double sp = sin(p);
+  // Observer to body, in Earth radii, in the hour angle frame
+  double x = (rp * cosDec * cosHA) - site.rhoCosLat;
+  double y = rp * cosDec * sinHA;
+  double z = (rp * sinDec) - site.rhoSinLat;
+  decRad = atan(cp * z / x);
+  topocentric.distance = sqrt((x * x) + (y * y) + (z * z)) * 4.263523e-5;
+  double ra = fmod(localSiderealTime - (p * 3.819718634), 24.0);
+  if (ra < 0.) ra += 24.0;
+  topocentric.rightAscension = ra;
+  topocentric.declination = decRad * 5.729577951e1;
+  // Same as doRAdec2AltAz()
+  cosDec = cos(decRad);
+  sinDec = sin(decRad);
+  double sinAlt = (sinDec * site.sinLat) + (cosDec * site.cosLat * cp);
+  double altRad = asin(sinAlt);
+  double b = site.cosLat * cos(altRad);
+  if (b < 1e-10) b = 1e-10;
+  double c = (sinDec - (site.sinLat * sinAlt)) / b;
+  if (c > 1.) c = 1.;
+  if (c < -1.) c = -1.;
+  double azRad = acos(c);
+  if (sp > 0) azRad = (2.0 * M_PI) - azRad;
+  topocentric.altitude = altRad * 5.729577951e1;
+  topocentric.azimuth = azRad * 5.729577951e1;
+}
+
+boolean SiderealPlanets::doLunarParallax(void) {
+  // The site terms were worked out by setLatLong() and setElevationM()
+  SiderealSiteConstants site = {decLong, sinLat, cosLat, rhoSinLat, rhoCosLat};
+  SiderealPosition geocentric, topocentric;
+  geocentric.rightAscension = RAdec;
+  geocentric.declination = rad2deg(DeclinationRad);
+  geocentric.distance = 4.263523e-5 / sin(deg2rad(EquatHorizontalParallax)); //Earth radius in AU
+  calcTopocentric(getLocalSiderealTime(), site, geocentric, topocentric);
+  RAdec = topocentric.rightAscension;
   RArad = deg2rad(RAdec) * 15.;
   sinRA = sin(RArad);
   cosRA = cos(RArad);
+  DeclinationRad = deg2rad(topocentric.declination);
   sinDec = sin(DeclinationRad);
   cosDec = cos(DeclinationRad);
   return true;
 }
 
+// Topocentric RA/Dec, alt/az and distance for a series of epochs at this site.
+// Each position holds a geocentric RA, Dec and distance (AU) on input, as
+// computed by doBody().  Epochs are days since 1900 January 0.5 GMT.
+boolean SiderealPlanets::doTopocentric(const double *epochs, SiderealPosition *positions, int count) {
+  if (epochs == NULL || positions == NULL) return false;
+  SiderealSiteConstants site = {decLong, sinLat, cosLat, rhoSinLat, rhoCosLat};
+  for (int i = 0; i < count; i++) {
+    double lst = calcGMTsiderealTime(epochs[i]) + (decLong / 15.0);
+    calcTopocentric(lst, site, positions[i], positions[i]);
+  }
+  return true;
+}
+
+// Work out the site terms of the parallax correction once per site
+void SiderealPlanets::calcSiteConstants(const SiderealSite &site, SiderealSiteConstants &constants) {
+  double phi = site.latitude * 1.745329252e-2;
+  double u = atan(9.96647e-1 * tan(phi)); // geocentric latitude
+  double ht = site.elevation / 6378140.0; // height in earth radii
+  constants.longitude = site.longitude;
+  constants.sinLat = sin(phi);
+  constants.cosLat = cos(phi);
+  constants.rhoSinLat = (9.96647e-1 * sin(u)) + (ht * constants.sinLat);
+  constants.rhoCosLat = cos(u) + (ht * constants.cosLat);
+}
+
+// One geocentric position seen from many sites at the same epoch
+boolean SiderealPlanets::doTopocentricSites(double epoch, const SiderealPosition &geocentric,
+    const SiderealSiteConstants *sites, SiderealPosition *output, int count) {
+  if (sites == NULL || output == NULL) return false;
+  double gst = calcGMTsiderealTime(epoch);
+  for (int i = 0; i < count; i++) {
+    calcTopocentric(gst + (sites[i].longitude / 15.0), sites[i], geocentric, output[i]);
+  }
+  return true;
+}
+
+// Greenwich sidereal time in hours for an epoch in days since 1900 January 0.5,
+// the same polynomial as getGMTsiderealTime()
+double SiderealPlanets::calcGMTsiderealTime(double epoch) {
+  double days = floor(epoch - 0.5) + 0.5; // 0h GMT
+  int year = 2000 + (int)(((days / 36525.0) - 1.) * 100.); // whole centuries drop out
+  return siderealRange(((epoch - days) * 24.0 * 1.002737908) + siderealGST0(days, year), 24.0);
+}
+
+// Topocentric altitude and azimuth (degrees) of a body (SP_SUN to SP_MOON)
+// from a moving observer, one point per epoch, with latitudes and longitudes
+// in degrees and elevations in meters.  The body is computed once at each
+// multiple of window (days) that the epochs span, and its geocentric
+// position, and the sidereal time, are interpolated linearly in between.
+// The epochs need not be in order, but in order each node is computed once.
+// Leaves the date, time and body position at the last node computed.
+boolean SiderealPlanets::doTrack(int body, const double *epochs, const double *latitudes, const double *longitudes,
+    const double *elevations, int count, double *altitudes, double *azimuths, double window) {
+  if (epochs == NULL || latitudes == NULL || longitudes == NULL || elevations == NULL ||
+    altitudes == NULL || azimuths == NULL || window <= 0.) return false; //bad input
+  if (body < SP_SUN || body > SP_MOON) return false; //bad body value
+  double node[2][4]; // equatorial x, y, z in Earth radii, and GST in hours
+  double first = 0.;
+  boolean haveNodes = false;
+  for (int i = 0; i < count; i++) {
+    double k = floor(epochs[i] / window);
+    if (!haveNodes || k * window != first) {
+      // Reuse the later node when the track moves into the next window
+      int from = 0;
+      if (haveNodes && (k - 1.) * window == first) {
+        for (int j = 0; j < 4; j++) node[0][j] = node[1][j];
+        from = 1;
+      }
+      first = k * window;
+      for (int n = from; n < 2; n++) {
+        double t = first + (n * window);
+        if (setGMTepoch(t) == false) return false;
+        doBody(body);
+        double rp = getBodyDistance() / 4.263523e-5; // distance in Earth radii
+        double ra = getRAdec() * 2.617993878e-1;
+        double dec = getDeclinationDec() * 1.745329252e-2;
+        node[n][0] = rp * cos(dec) * cos(ra);
+        node[n][1] = rp * cos(dec) * sin(ra);
+        node[n][2] = rp * sin(dec);
+        node[n][3] = calcGMTsiderealTime(t);
+      }
+      // Keep the sidereal time increasing across 0h
+      if (node[1][3] < node[0][3]) node[1][3] += 24.;
+      haveNodes = true;
+    }
+    // From here on only plain arithmetic on this point, so the loop stays
+    // tight: interpolate, then shift to the observer and turn to East,
+    // North, Up
+    double f = (epochs[i] - first) / window;
+    double x = node[0][0] + (f * (node[1][0] - node[0][0]));
+    double y = node[0][1] + (f * (node[1][1] - node[0][1]));
+    double z = node[0][2] + (f * (node[1][2] - node[0][2]));
+    double theta = ((node[0][3] + (f * (node[1][3] - node[0][3]))) * 2.617993878e-1) +
+      (longitudes[i] * 1.745329252e-2);
+    double phi = latitudes[i] * 1.745329252e-2;
+    double sinPhi = sin(phi);
+    double cosPhi = cos(phi);
+    double sinTheta = sin(theta);
+    double cosTheta = cos(theta);
+    // Same site terms as setLatLong() and setElevationM(), without the atan()
+    double c = 1. / sqrt((cosPhi * cosPhi) + (9.93305e-1 * sinPhi * sinPhi));
+    double ht = elevations[i] / 6378140.0; // height in earth radii
+    double rhoCos = (c + ht) * cosPhi;
+    double rhoSin = ((9.93305e-1 * c) + ht) * sinPhi;
+    x -= rhoCos * cosTheta;
+    y -= rhoCos * sinTheta;
+    z -= rhoSin;
+    double east = (y * cosTheta) - (x * sinTheta);
+    double along = (x * cosTheta) + (y * sinTheta);
+    double north = (z * cosPhi) - (along * sinPhi);
+    double up = (z * sinPhi) + (along * cosPhi);
+    altitudes[i] = atan2(up, sqrt((east * east) + (north * north))) * 5.729577951e1;
+    double az = atan2(east, north) * 5.729577951e1;
+    azimuths[i] = (az < 0.) ? az + 360. : az;
+  }
+  return true;
+}
+
+// Altitude and azimuth (degrees) of every cell of an RA/Dec grid at the
+// current site and time: raCount columns from raStart in steps of raStep
+// (hours) and decCount rows from decStart in steps of decStep (degrees).
+// The rasters hold decCount rows of raCount values.  Declination terms are
+// worked out once per row, and hour angle terms once per grid by turning
+// one step at a time, so each cell is a few products, asin() and atan2().
+// The turn is restarted from cos() and sin() every 64 columns, so rounding
+// cannot build up along long rows.
+boolean SiderealPlanets::doSkyGrid(double raStart, double raStep, int raCount, double decStart, double decStep,
+    int decCount, float *altitudes, float *azimuths) {
+  if (altitudes == NULL || azimuths == NULL || raCount < 0 || decCount < 0) return false; //bad input
+  double h0 = (getLocalSiderealTime() - raStart) * 2.617993878e-1; // hour angle of column 0
+  double dh = raStep * 2.617993878e-1;
+  double cosStep = cos(dh), sinStep = sin(dh);
+  for (int row = 0; row < decCount; row++) {
+    double decRad = (decStart + (row * decStep)) * 1.745329252e-2;
+    double sd = sin(decRad);
+    double cd = cos(decRad);
+    double a = sd * sinLat, b = cd * cosLat;       // sin(alt) = a + b cos(H)
+    double c = sd * cosLat, d = cd * sinLat;       // North part = c - d cos(H)
+    double cosH = 1., sinH = 0.;
+    float *alt = altitudes + ((long)row * raCount);
+    float *az = azimuths + ((long)row * raCount);
+    for (int col = 0; col < raCount; col++) {
+      if ((col & 63) == 0) {
+        cosH = cos(h0 - (col * dh));
+        sinH = sin(h0 - (col * dh));
+      }
+      double s = a + (b * cosH); // may round just past 1 at the zenith
+      if (s > 1.) s = 1.;
+      if (s < -1.) s = -1.;
+      alt[col] = asin(s) * 5.729577951e1;
+      double z = atan2(-cd * sinH, c - (d * cosH)) * 5.729577951e1;
+      az[col] = (z < 0.) ? z + 360. : z;
+      // Next column: RA up one step, so the hour angle down one step
+      double ch = (cosH * cosStep) + (sinH * sinStep);
+      sinH = (sinH * cosStep) - (cosH * sinStep);
+      cosH = ch;
+    }
+  }
+  return true;
+}
+
+// RA (hours) and Dec (degrees) of many alt/az directions (degrees) at the
+// current site and time, such as the pixels of an all-sky camera.  The
+// rotation from the horizon to the equator is set up once for the batch.
+boolean SiderealPlanets::doAltAz2RAdec(const float *altitudes, const float *azimuths, long count,
+    float *rightAscensions, float *declinations) {
+  if (altitudes == NULL || azimuths == NULL || rightAscensions == NULL || declinations == NULL) return false; //bad input
+  double m[3][3];
+  calcHorizon2Equator(m);
+  for (long i = 0; i < count; i++) {
+    float alt = altitudes[i] * 1.745329252e-2f;
+    float az = azimuths[i] * 1.745329252e-2f;
+    float ca = cosf(alt);
+    calcVector2RAdec(m, ca * sinf(az), ca * cosf(az), sinf(alt), rightAscensions[i], declinations[i]);
+  }
+  return true;
+}
+
+// The same for unit direction vectors in the site's East, North, Up frame,
+// which for a fixed camera can be worked out once from the lens model
+boolean SiderealPlanets::doVector2RAdec(const float *east, const float *north, const float *up, long count,
+    float *rightAscensions, float *declinations) {
+  if (east == NULL || north == NULL || up == NULL || rightAscensions == NULL || declinations == NULL) return false; //bad input
+  double m[3][3];
+  calcHorizon2Equator(m);
+  for (long i = 0; i < count; i++) {
+    calcVector2RAdec(m, east[i], north[i], up[i], rightAscensions[i], declinations[i]);
+  }
+  return true;
+}
+
+#ifndef SIDEREAL_PLANETS_NO_MOON
 float SiderealPlanets::getLunarLuminance() {
-  double tmpRArad, tmpRAdec, tmpDeclinationRad, tmpDeclinationDec;
-  float SD_local, CD_local, D_local, Irad, K_local;
-  
   // Make sure called doMoon() first, before calling this function
   if (!doMoonDone) doMoon();
-  // Save off current RA/Dec, which we assume is for the Moon
-  tmpRArad = RArad;
-  tmpRAdec = RAdec;
-  tmpDeclinationRad = DeclinationRad;
-  tmpDeclinationDec = DeclinationDec;
-  
-  // Call Sun routine
-  doSun();
+  // Only the Sun's longitude is needed, so the Moon's RA/Dec stay as they are
+  doSunLongitude();
+  calcLunarIllumination();
+  getLunarLuminanceDone = true;
+  return LunarIrradiance * 100.0;
+}
+
+double SiderealPlanets::calcLunarIllumination(void) {
+  // Phase angle in radians from the last doMoon() and doSunLongitude()
+  float SD_local, CD_local, D_local, Irad, K_local;
   CD_local = cos(moonGeocentricEclipticLongitude - sunTrueGeocentricLongitude) * cos(moonGeocentricEclipticLatitude);
   D_local = 1.570796327 - asin(CD_local);
   SD_local =sin(D_local);
@@ -776,14 +1062,7 @@ float SiderealPlanets::getLunarLuminance() {
   Irad = FPI - D_local - deg2rad(Irad);
   K_local = (1.0 + cos(Irad)) / 2.0;
   LunarIrradiance = int(K_local * 10000.0 + 0.5) / 10000.0;
-  // Restore RA/Dec
-  RArad = tmpRArad;
-  RAdec = tmpRAdec;
-  DeclinationRad = tmpDeclinationRad;
-  DeclinationDec = tmpDeclinationDec;
-  doMoonDone = true;
-  getLunarLuminanceDone = true;
-  return LunarIrradiance * 100.0;
+  return Irad;
 }
 
 int SiderealPlanets::getMoonPhase() {
@@ -798,10 +1077,15 @@ int SiderealPlanets::getMoonPhase() {
   7. Waning Crescent
   */
   // Make sure doMoon() called first, before calling this function
-  double modphase = fmod((modifiedJulianDate1900() - 45212.25), 29.53059);
-  if (modphase < 0.) modphase = fmod((29.53059 + modphase), 29.53059);
   if (!doMoonDone) doMoon();
   if (!getLunarLuminanceDone) getLunarLuminance();
+  return calcMoonPhase();
+}
+
+int SiderealPlanets::calcMoonPhase(void) {
+  // Phase class from LunarIrradiance, with the mean lunation telling waxing from waning
+  double modphase = fmod((modifiedJulianDate1900() - 45212.25), 29.53059);
+  if (modphase < 0.) modphase = fmod((29.53059 + modphase), 29.53059);
   if (LunarIrradiance < 0.02) return 0; // New Moon
   if (LunarIrradiance > 0.98) return 4; // Full Moon
   if (modphase < (29.53059 / 2.)) {
@@ -816,6 +1100,53 @@ int SiderealPlanets::getMoonPhase() {
   return 0;
 }
 
+boolean SiderealPlanets::doSunMoon(SiderealMoonPhase &moon) {
+  // doMoon() plus the Sun's longitude only: the Moon's position and lighting
+  // in one pass, leaving getLunarLuminance() and getMoonPhase() ready
+  doMoon();
+  doSunLongitude();
+  double phaseAngle = calcLunarIllumination();
+  getLunarLuminanceDone = true;
+  moon.epoch = getGMTepoch();
+  moon.rightAscension = RAdec;
+  moon.declination = DeclinationDec;
+  moon.distance = 4.263523e-5 / sin(moonHorizontalParallax); //Earth radius in AU
+  moon.sunLongitude = rad2deg(sunTrueGeocentricLongitude);
+  moon.illumination = (1.0 + cos(phaseAngle)) / 2.0;
+  moon.phaseAngle = rad2deg(phaseAngle);
+  moon.phase = calcMoonPhase();
+  return true;
+}
+
+// The same for an array of epochs (days since 1900 January 0.5 GMT).
+// Leaves the date and time at the last epoch.
+boolean SiderealPlanets::doSunMoon(const double *epochs, SiderealMoonPhase *moons, int count) {
+  if (epochs == NULL || moons == NULL) return false;
+  for (int i = 0; i < count; i++) {
+    if (setGMTepoch(epochs[i]) == false) return false;
+    doSunMoon(moons[i]);
+  }
+  return true;
+}
+
+// One entry per day of a GMT month, at the GMT time of day now set.
+// days must hold 31 entries.  Leaves the date at the last day.
+boolean SiderealPlanets::doMoonCalendar(int year, int month, SiderealMoonPhase *days, int &dayCount) {
+  if (days == NULL || month < 1 || month > 12) return false; //bad input
+  double fraction = GMTtime / 24.0;
+  double first = siderealMJD1900(year, month, 1);
+  double next = (month == 12) ? siderealMJD1900(year + 1, 1, 1) : siderealMJD1900(year, month + 1, 1);
+  if (first < -9999990. || next < -9999990.) return false; //date dropped in 1582
+  dayCount = (int)(next - first);
+  for (int i = 0; i < dayCount; i++) {
+    if (setGMTepoch(first + i + fraction) == false) return false;
+    doSunMoon(days[i]);
+  }
+  return true;
+}
+
+#endif
+
 boolean SiderealPlanets::setEquatHorizontalParallax(double hp) {
   //This is here for testing only - not to be used in Real Life!
   //That's why it's left undocumented
@@ -829,6 +1160,7 @@ double SiderealPlanets::getEquatHorizontalParallax(void) {
   return EquatHorizontalParallax;
 }
 
+#ifndef SIDEREAL_PLANETS_NO_REFRACTION
 boolean SiderealPlanets::doRefractionF(double pressure, double temperature) {
   pressure *= 33.8639;
   temperature = (temperature - 32.) * (5. / 9.);
@@ -837,37 +1169,19 @@ boolean SiderealPlanets::doRefractionF(double pressure, double temperature) {
 }
 
 boolean SiderealPlanets::doRefractionC(double pressure, double temperature) {
-  double rf = 0.;
   AltDec = rad2deg(AltRad);
   //Valid for any values above -5 degrees
-  double y = AltRad;
-  double y1 = AltRad;
-  double y2 = AltRad;
   double r1 = 0.0;
   double r2 = r1;
-  double q;
   do {
 	r1 = r2;
-	y = y1 + r1;
-	q = y;
-    if (y >= 2.617994e-1) {
-      rf = 7.888888e-5 * pressure / ((273 + temperature) * tan(y));
-    } else {
-      if (y >= -8.7e-2) {
-        double yd = y * 5.729578e1;
-        double a = ((2e-5 * yd + 1.96e-2) * yd + 1.594e-1) * pressure;
-        double b = (273 + temperature) * ((8.45e-2 * yd + 5.05e-1) * yd + 1.0);
-        rf = (a / b) * 1.745329e-2;
-      }
-    }
-	r2 = rf;
+	r2 = calcRefraction(AltRad + r1, pressure, temperature);
   } while (r2 != 0. && abs(r2 - r1) > 1e-6);
-  y = y2;
-  AltRad = AltRad + rf;
+  AltRad = AltRad + r2;
   sinAlt = sin(AltRad);
   cosAlt = cos(AltRad);
   //SerialUSB.print("Correction ");
-  //printDegMinSecs(rad2deg(rf));
+  //printDegMinSecs(rad2deg(r2));
   //SerialUSB.println();
   return true;
 }
@@ -880,19 +1194,9 @@ boolean SiderealPlanets::doAntiRefractionF(double pressure, double temperature)
 }
 
 boolean SiderealPlanets::doAntiRefractionC(double pressure, double temperature) {
-  double rf = 0.;
   AltDec = rad2deg(AltRad);
   //Valid for any values above -5 degrees
-  if (AltRad >= 2.617994e-1) {
-    rf = -7.888888e-5 * pressure / ((273 + temperature) * tan(AltRad));
-  } else {
-    if (AltRad >= -8.7e-2) {
-      double yd = AltRad * 5.729578e1;
-      double a = ((2e-5 * yd + 1.96e-2) * yd + 1.594e-1) * pressure;
-      double b = (273 + temperature) * ((8.45e-2 * yd + 5.05e-1) * yd + 1.0);
-      rf = -(a / b) * 1.745329e-2;
-    }
-  }
+  double rf = -calcRefraction(AltRad, pressure, temperature);
   AltRad = AltRad + rf;
   sinAlt = sin(AltRad);
   cosAlt = cos(AltRad);
@@ -902,6 +1206,25 @@ boolean SiderealPlanets::doAntiRefractionC(double pressure, double temperature)
   return true;
 }
 
+// Refraction in radians at altitude y (radians), pressure in millibars and
+// temperature in Celsius. Zero below -5 degrees, where the formula is not valid.
+// Shared by doRefractionC(), doAntiRefractionC() and SiderealRefraction tables.
+double SiderealPlanets::calcRefraction(double y, double pressure, double temperature) {
+  if (y >= 2.617994e-1) {
+    return 7.888888e-5 * pressure / ((273 + temperature) * tan(y));
+  }
+  if (y >= -8.7e-2) {
+    double yd = y * 5.729578e1;
+    double a = ((2e-5 * yd + 1.96e-2) * yd + 1.594e-1) * pressure;
+    double b = (273 + temperature) * ((8.45e-2 * yd + 5.05e-1) * yd + 1.0);
+    return (a / b) * 1.745329e-2;
+  }
+  return 0.;
+}
+
+#endif
+
+#ifndef SIDEREAL_PLANETS_NO_RISESET
 boolean SiderealPlanets::doRiseSetTimes(double DIdeg) {
   //horizonVerticalDisplacement = vertical displacement in radians
   double horizonVerticalDisplacement = deg2rad(DIdeg);
@@ -930,6 +1253,8 @@ double SiderealPlanets::getSetTime(void) {
   return doLST2LT(localSiderealTimeSetting);
 }
 
+#endif
+
 double SiderealPlanets::doAnomaly(double meanAnomaly, double eccentricity) {
   //Returns eccentric anomaly in degrees given the mean anomaly in degrees
   //and eccentricity for an elliptical orbit.
@@ -959,6 +1284,20 @@ double SiderealPlanets::getTrueAnomaly(void) {
 }
 
 boolean SiderealPlanets::doSun(void) {
+  doSunLongitude();
+  // Apparent ecliptic longitude
+  doNutation();
+  double apparentEclipticLongitude = rad2deg(sunTrueGeocentricLongitude) + nutationInLongitude - 5.69e-3;
+  Ecl2RaDecDone = false;
+  setEcliptic(apparentEclipticLongitude, 0.0);
+  doEcliptic2RAdec();
+  
+  return true;
+}
+
+void SiderealPlanets::doSunLongitude(void) {
+  // The Sun's true geocentric longitude and distance, without the nutation
+  // and RA/Dec steps, for the routines that only need those
   julianCenturies1900 = (modifiedJulianDate1900() / 36525.0) + (getGMT() / 8.766e5);
   double T2_local = julianCenturies1900 * julianCenturies1900;
   double A_local = 1.000021359e2 * julianCenturies1900;
@@ -966,7 +1305,7 @@ boolean SiderealPlanets::doSun(void) {
   double L_local = 2.7969668e2 + 3.025e-4 * T2_local + B_local;
   A_local = 9.999736042e1 * julianCenturies1900;
   B_local = 360.0 * (A_local - floor(A_local));
-  meanAnomaly = 3.5847583e2 - (1.5e-4 + 3.3e-6 * julianCenturies1900) * T2_local + B_local;
+  double meanAnomaly = 3.5847583e2 - (1.5e-4 + 3.3e-6 * julianCenturies1900) * T2_local + B_local;
   double eccentricity = 1.675104e-2 - 4.18e-5 * julianCenturies1900 - 1.26e-7 * T2_local;
   doAnomaly(meanAnomaly, eccentricity);
   
@@ -999,15 +1338,175 @@ boolean SiderealPlanets::doSun(void) {
   sunEarthDistance = 1.0000002 * (1.0 - eccentricity * cos(eccentricAnomaly)) + D3_local;
   // true geocentric longitude of the Sun
   sunTrueGeocentricLongitude = inRange2PI(sunTrueGeocentricLongitude);
-  
-  // Apparent ecliptic longitude
-  doNutation();
-  apparentEclipticLongitude = rad2deg(sunTrueGeocentricLongitude) + nutationInLongitude - 5.69e-3;
-  Ecl2RaDecDone = false;
-  setEcliptic(apparentEclipticLongitude, 0.0);
-  doEcliptic2RAdec();
-  
-  return true;
+}
+
+#ifndef SIDEREAL_PLANETS_NO_MOON
+// Terms of the Moon's longitude, latitude and horizontal parallax series,
+// largest first so that setAccuracy() can stop early.  Each term is the
+// amplitude in degrees, the multiples of D, M, M' and F in the argument, and
+// the power of E it is scaled by.
+static const double moonLongitudeTerms[] PROGMEM = {
+  6.28875, 0, 0, 1, 0, 0,
+  1.274018, 2, 0, -1, 0, 0,
+  0.658309, 2, 0, 0, 0, 0,
+  0.213616, 0, 0, 2, 0, 0,
+  -0.185596, 0, 1, 0, 0, 1,
+  -0.114336, 0, 0, 0, 2, 0,
+  0.058793, 2, 0, -2, 0, 0,
+  0.057212, 2, -1, -1, 0, 1,
+  0.05332, 2, 0, 1, 0, 0,
+  0.045874, 2, -1, 0, 0, 1,
+  0.041024, 0, -1, 1, 0, 1,
+  -0.034718, 1, 0, 0, 0, 0,
+  -0.030465, 0, 1, 1, 0, 1,
+  0.015326, 2, 0, 0, -2, 0,
+  -0.012528, 0, 0, 1, 2, 0,
+  -0.01098, 0, 0, -1, 2, 0,
+  0.010674, 4, 0, -1, 0, 0,
+  0.010034, 0, 0, 3, 0, 0,
+  0.008548, 4, 0, -2, 0, 0,
+  -0.00791, 2, 1, -1, 0, 1,
+  -0.006783, 2, 1, 0, 0, 1,
+  0.005162, -1, 0, 1, 0, 0,
+  0.005, 1, 1, 0, 0, 1,
+  0.004049, 2, -1, 1, 0, 1,
+  0.003996, 2, 0, 2, 0, 0,
+  0.003862, 4, 0, 0, 0, 0,
+  0.003665, 2, 0, -3, 0, 0,
+  0.002695, 0, -1, 2, 0, 1,
+  0.002602, -2, 0, 1, -2, 0,
+  0.002396, 2, -1, -2, 0, 1,
+  -0.002349, 1, 0, 1, 0, 0,
+  0.002249, 2, -2, 0, 0, 2,
+  -0.002125, 0, 1, 2, 0, 1,
+  -0.002079, 0, 2, 0, 0, 2,
+  0.002059, 2, -2, -1, 0, 2,
+  -0.001773, 2, 0, 1, -2, 0,
+  -0.001595, 2, 0, 0, 2, 0,
+  0.00122, 4, -1, -1, 0, 1,
+  -0.00111, 0, 0, 2, 2, 0,
+  8.920e-04, -3, 0, 1, 0, 0,
+  -8.110e-04, 2, 1, 1, 0, 1,
+  7.610e-04, 4, -1, -2, 0, 1,
+  7.170e-04, 0, -2, 1, 0, 2,
+  7.040e-04, -2, -2, 1, 0, 2,
+  6.930e-04, 2, 1, -2, 0, 1,
+  5.980e-04, 2, -1, 0, -2, 1,
+  5.500e-04, 4, 0, 1, 0, 0,
+  5.380e-04, 0, 0, 4, 0, 0,
+  5.210e-04, 4, -1, 0, 0, 1,
+  4.860e-04, -1, 0, 2, 0, 0
+};
+static const double moonLatitudeTerms[] PROGMEM = {
+  5.128189, 0, 0, 0, 1, 0,
+  0.280606, 0, 0, 1, 1, 0,
+  0.277693, 0, 0, 1, -1, 0,
+  0.173238, 2, 0, 0, -1, 0,
+  0.055413, 2, 0, -1, 1, 0,
+  0.046272, 2, 0, -1, -1, 0,
+  0.032573, 2, 0, 0, 1, 0,
+  0.017198, 0, 0, 2, 1, 0,
+  0.009267, 2, 0, 1, -1, 0,
+  0.008823, 0, 0, 2, -1, 0,
+  0.008247, 2, -1, 0, -1, 1,
+  0.004323, 2, 0, -2, -1, 0,
+  0.0042, 2, 0, 1, 1, 0,
+  0.003372, -2, -1, 0, 1, 1,
+  0.002472, 2, -1, -1, 1, 1,
+  0.002222, 2, -1, 0, 1, 1,
+  0.002072, 2, -1, -1, -1, 1,
+  0.001877, 0, -1, 1, 1, 1,
+  0.001828, 4, 0, -1, -1, 0,
+  -0.001803, 0, 1, 0, 1, 1,
+  -0.00175, 0, 0, 0, 3, 0,
+  0.00157, 0, -1, 1, -1, 1,
+  -0.001487, 1, 0, 0, 1, 0,
+  -0.001481, 0, 1, 1, 1, 1,
+  0.001417, 0, -1, -1, 1, 1,
+  0.00135, 0, -1, 0, 1, 1,
+  0.00133, -1, 0, 0, 1, 0,
+  0.001106, 0, 0, 3, 1, 0,
+  0.00102, 4, 0, 0, -1, 0,
+  8.330e-04, 4, 0, -1, 1, 0,
+  7.810e-04, 0, 0, 1, -3, 0,
+  6.700e-04, 4, 0, -2, 1, 0,
+  6.060e-04, 2, 0, 0, -3, 0,
+  5.970e-04, 2, 0, 2, -1, 0,
+  4.920e-04, 2, -1, 1, -1, 1,
+  4.500e-04, -2, 0, 2, -1, 0,
+  4.390e-04, 0, 0, 3, -1, 0,
+  4.230e-04, 2, 0, 2, 1, 0,
+  4.220e-04, 2, 0, -3, -1, 0,
+  -3.670e-04, 2, 1, -1, 1, 1,
+  -3.530e-04, 2, 1, 0, 1, 1,
+  3.310e-04, 4, 0, 0, 1, 0,
+  3.170e-04, 2, -1, 1, 1, 1,
+  3.060e-04, 2, -2, 0, -1, 2,
+  -2.830e-04, 0, 0, 1, 3, 0
+};
+static const double moonParallaxTerms[] PROGMEM = {
+  0.051818, 0, 0, 1, 0, 0,
+  0.009531, 2, 0, -1, 0, 0,
+  0.007843, 2, 0, 0, 0, 0,
+  0.002824, 0, 0, 2, 0, 0,
+  8.570e-04, 2, 0, 1, 0, 0,
+  5.330e-04, 2, -1, 0, 0, 1,
+  4.010e-04, 2, -1, -1, 0, 1,
+  3.200e-04, 0, -1, 1, 0, 1,
+  -2.710e-04, 1, 0, 0, 0, 0,
+  -2.640e-04, 0, 1, 1, 0, 1,
+  -1.980e-04, 0, 0, -1, 2, 0,
+  1.730e-04, 0, 0, 3, 0, 0,
+  1.670e-04, 4, 0, -1, 0, 0,
+  -1.110e-04, 0, 1, 0, 0, 1,
+  1.030e-04, 4, 0, -2, 0, 0,
+  -8.400e-05, -2, 0, 2, 0, 0,
+  -8.300e-05, 2, 1, 0, 0, 1,
+  7.900e-05, 2, 0, 2, 0, 0,
+  7.200e-05, 4, 0, 0, 0, 0,
+  6.400e-05, 2, -1, 1, 0, 1,
+  -6.300e-05, 2, 1, -1, 0, 1,
+  4.100e-05, 1, 1, 0, 0, 1,
+  3.500e-05, 0, -1, 2, 0, 1,
+  -3.300e-05, -2, 0, 3, 0, 0,
+  -3.000e-05, 1, 0, 1, 0, 0,
+  -2.900e-05, -2, 0, 0, 2, 0,
+  -2.900e-05, 0, 1, 2, 0, 1,
+  2.600e-05, 2, -2, 0, 0, 2,
+  -2.300e-05, -2, 0, 1, 2, 0,
+  1.900e-05, 4, -1, -1, 0, 1
+};
+
+#endif
+
+#if !defined(SIDEREAL_PLANETS_NO_MOON) || !defined(SIDEREAL_PLANETS_NO_PLANETS)
+// Read one entry of a table that may live in AVR program memory
+static double readTable(const double *table, int k) {
+#if defined(__AVR__)
+  return pgm_read_float(&table[k]); // double is a 4 byte float on AVR
+#else
+  return table[k];
+#endif
+}
+
+#endif
+
+#ifndef SIDEREAL_PLANETS_NO_MOON
+// Sum of the terms of one Moon series down to the threshold amplitude
+static double calcMoonSeries(const double *table, int count, double threshold, boolean cosine,
+    double D, double M, double Mp, double F, double E) {
+  double sum = 0.;
+  for (int k = 0; k < count * 6; k += 6) {
+    double amplitude = readTable(table, k);
+    if (fabs(amplitude) < threshold) break;
+    double argument = (readTable(table, k + 1) * D) + (readTable(table, k + 2) * M) +
+      (readTable(table, k + 3) * Mp) + (readTable(table, k + 4) * F);
+    int power = (int)readTable(table, k + 5);
+    if (power == 1) amplitude *= E;
+    if (power == 2) amplitude *= E * E;
+    sum += amplitude * (cosine ? cos(argument) : sin(argument));
+  }
+  return sum;
 }
 
 boolean SiderealPlanets::doMoon(void) {
@@ -1051,87 +1550,25 @@ boolean SiderealPlanets::doMoon(void) {
   moonMeanDistanceAcendingNode = moonMeanDistanceAcendingNode + S3_local - 2.4691E-2 * S2_local - 4.328E-3 * S4_local;
   moonMeanElongation = moonMeanElongation + 2.011E-3 * S1_local + S3_local + 1.964E-3 * S2_local;
   double E_local = 1. - (2.495E-3 + 7.52E-6 * julianCenturies1900) * julianCenturies1900;
-  double E2_local = E_local * E_local;
   moonMeanLongitude = deg2rad(moonMeanLongitude);
   sunMeanAnomaly = deg2rad(sunMeanAnomaly);
   moonLongitudeAscendingNode = deg2rad(moonLongitudeAscendingNode);
   moonMeanElongation = deg2rad(moonMeanElongation);
   moonMeanDistanceAcendingNode = deg2rad(moonMeanDistanceAcendingNode);
   moonMeanAnomaly = deg2rad(moonMeanAnomaly);
-  double L_local = 6.28875 * sin(moonMeanAnomaly) + 1.274018 * sin(2. * moonMeanElongation - moonMeanAnomaly);
-  L_local = L_local + 6.58309e-1 * sin(2. * moonMeanElongation) + 2.13616e-1 * sin(2. * moonMeanAnomaly);
-  L_local = L_local - E_local * 1.85596E-1 * sin(sunMeanAnomaly) - 1.14336E-1 * sin(2. * moonMeanDistanceAcendingNode);
-  L_local = L_local + 5.8793E-2 * sin(2. * (moonMeanElongation - moonMeanAnomaly));
-  L_local = L_local + 5.7212E-2 * E_local * sin(2. * moonMeanElongation - sunMeanAnomaly - moonMeanAnomaly) + 5.332E-2 * sin(2. * moonMeanElongation + moonMeanAnomaly);
-  L_local = L_local + 4.5874E-2 * E_local * sin(2. * moonMeanElongation - sunMeanAnomaly) + 4.1024E-2 * E_local * sin(moonMeanAnomaly - sunMeanAnomaly);
-  L_local = L_local - 3.4718E-2 * sin(moonMeanElongation) - E_local * 3.0465E-2 * sin(sunMeanAnomaly + moonMeanAnomaly);
-  L_local = L_local + 1.5326E-2 * sin(2. * (moonMeanElongation - moonMeanDistanceAcendingNode)) - 1.2528E-2 * sin(2. * moonMeanDistanceAcendingNode + moonMeanAnomaly);
-  L_local = L_local - 1.098E-2 * sin(2. * moonMeanDistanceAcendingNode - moonMeanAnomaly) + 1.0674E-2 * sin(4. * moonMeanElongation - moonMeanAnomaly);
-  L_local = L_local + 1.0034E-2 * sin(3. * moonMeanAnomaly) + 8.548E-3 * sin(4. * moonMeanElongation - 2. * moonMeanAnomaly);
-  L_local = L_local - E_local * 7.91E-3 * sin(sunMeanAnomaly - moonMeanAnomaly + 2. * moonMeanElongation) - E_local * 6.783E-3 * sin(2. * moonMeanElongation + sunMeanAnomaly);
-  L_local = L_local + 5.162E-3 * sin(moonMeanAnomaly - moonMeanElongation) + E_local * 5E-3 * sin(sunMeanAnomaly + moonMeanElongation);
-  L_local = L_local + 3.862E-3 * sin(4. * moonMeanElongation) + E_local * 4.049E-3 * sin(moonMeanAnomaly - sunMeanAnomaly + 2. * moonMeanElongation);
-  L_local = L_local + 3.996E-3 * sin(2. * (moonMeanAnomaly + moonMeanElongation)) + 3.665E-3 * sin(2. * moonMeanElongation - 3. * moonMeanAnomaly);
-  L_local = L_local + E_local * 2.695E-3 * sin(2. * moonMeanAnomaly - sunMeanAnomaly) + 2.602E-3 * sin(moonMeanAnomaly - 2. * (moonMeanDistanceAcendingNode + moonMeanElongation));
-  L_local = L_local + E_local * 2.396E-3 * sin(2. * (moonMeanElongation - moonMeanAnomaly) - sunMeanAnomaly) - 2.349E-3 * sin(moonMeanAnomaly + moonMeanElongation);
-  L_local = L_local + E2_local * 2.249E-3 * sin(2. * (moonMeanElongation - sunMeanAnomaly)) - E_local * 2.125E-3 * sin(2. * moonMeanAnomaly + sunMeanAnomaly);
-  L_local = L_local - E2_local * 2.079E-3 * sin(2. * sunMeanAnomaly) + E2_local * 2.059E-3 * sin(2. * (moonMeanElongation - sunMeanAnomaly) - moonMeanAnomaly);
-  L_local = L_local - 1.773E-3 * sin(moonMeanAnomaly + 2. * (moonMeanElongation - moonMeanDistanceAcendingNode)) - 1.595E-3 * sin(2. * (moonMeanDistanceAcendingNode + moonMeanElongation));
-  L_local = L_local + E_local * 1.22E-3 * sin(4. * moonMeanElongation - sunMeanAnomaly - moonMeanAnomaly) - 1.11E-3 * sin(2. * (moonMeanAnomaly + moonMeanDistanceAcendingNode));
-  L_local = L_local + 8.92E-4 * sin(moonMeanAnomaly - 3. * moonMeanElongation) - E_local * 8.11E-4 * sin(sunMeanAnomaly + moonMeanAnomaly + 2. * moonMeanElongation);
-  L_local = L_local + E_local * 7.61E-4 * sin(4. * moonMeanElongation - sunMeanAnomaly - 2. * moonMeanAnomaly);
-  L_local = L_local + E2_local * 7.04E-4 * sin(moonMeanAnomaly - 2. * (sunMeanAnomaly + moonMeanElongation));
-  L_local = L_local + E_local * 6.93E-4 * sin(sunMeanAnomaly - 2. * (moonMeanAnomaly - moonMeanElongation));
-  L_local = L_local + E_local * 5.98E-4 * sin(2. * (moonMeanElongation - moonMeanDistanceAcendingNode) - sunMeanAnomaly);
-  L_local = L_local + 5.5E-4 * sin(moonMeanAnomaly + 4 * moonMeanElongation) + 5.38E-4 * sin(4. * moonMeanAnomaly);
-  L_local = L_local + E_local * 5.21E-4 * sin(4. * moonMeanElongation - sunMeanAnomaly) + 4.86E-4 * sin(2. * moonMeanAnomaly - moonMeanElongation);
-  L_local = L_local + E2_local * 7.17E-4 * sin(moonMeanAnomaly - 2. * sunMeanAnomaly);
+  // Series terms smaller than this many degrees are skipped
+  double seriesThreshold = (accuracy == SP_ACCURACY_FULL) ? 0. : ((accuracy == SP_ACCURACY_ARCMINUTE) ? 1e-3 : 3e-2);
+  double L_local = calcMoonSeries(moonLongitudeTerms, sizeof(moonLongitudeTerms) / (6 * sizeof(double)), seriesThreshold,
+    false, moonMeanElongation, sunMeanAnomaly, moonMeanAnomaly, moonMeanDistanceAcendingNode, E_local);
   moonGeocentricEclipticLongitude = inRange2PI(moonMeanLongitude + deg2rad(L_local)); //Moon's geocentric ecliptic longitude
 
-  double G_local = 5.128189 * sin(moonMeanDistanceAcendingNode) + 2.80606e-1 * sin(moonMeanAnomaly + moonMeanDistanceAcendingNode);
-  G_local = G_local + 2.77693E-1 * sin(moonMeanAnomaly - moonMeanDistanceAcendingNode) + 1.73238E-1 * sin(2. * moonMeanElongation - moonMeanDistanceAcendingNode);
-  G_local = G_local + 5.5413E-2 * sin(2. * moonMeanElongation + moonMeanDistanceAcendingNode - moonMeanAnomaly) + 4.6272E-2 * sin(2. * moonMeanElongation - moonMeanDistanceAcendingNode - moonMeanAnomaly);
-  G_local = G_local + 3.2573E-2 * sin(2. * moonMeanElongation + moonMeanDistanceAcendingNode) + 1.7198E-2 * sin(2. * moonMeanAnomaly + moonMeanDistanceAcendingNode);
-  G_local = G_local + 9.267E-3 * sin(2. * moonMeanElongation + moonMeanAnomaly - moonMeanDistanceAcendingNode) + 8.823E-3 * sin(2. * moonMeanAnomaly - moonMeanDistanceAcendingNode);
-  G_local = G_local + E_local * 8.247E-3 * sin(2. * moonMeanElongation - sunMeanAnomaly - moonMeanDistanceAcendingNode) + 4.323E-3 * sin(2. * (moonMeanElongation - moonMeanAnomaly) - moonMeanDistanceAcendingNode);
-  G_local = G_local + 4.2E-3 * sin(2. * moonMeanElongation + moonMeanDistanceAcendingNode + moonMeanAnomaly) + E_local * 3.372E-3 * sin(moonMeanDistanceAcendingNode - sunMeanAnomaly - 2. * moonMeanElongation);
-  G_local = G_local + E_local * 2.472E-3 * sin(2. * moonMeanElongation + moonMeanDistanceAcendingNode - sunMeanAnomaly - moonMeanAnomaly);
-  G_local = G_local + E_local * 2.222E-3 * sin(2. * moonMeanElongation + moonMeanDistanceAcendingNode - sunMeanAnomaly);
-  G_local = G_local + E_local * 2.072E-3 * sin(2. * moonMeanElongation - moonMeanDistanceAcendingNode - sunMeanAnomaly - moonMeanAnomaly);
-  G_local = G_local + E_local * 1.877E-3 * sin(moonMeanDistanceAcendingNode - sunMeanAnomaly + moonMeanAnomaly) + 1.828E-3 * sin(4. * moonMeanElongation - moonMeanDistanceAcendingNode - moonMeanAnomaly);
-  G_local = G_local - E_local * 1.803E-3 * sin(moonMeanDistanceAcendingNode + sunMeanAnomaly) - 1.75E-3 * sin(3. * moonMeanDistanceAcendingNode);
-  G_local = G_local + E_local * 1.57E-3 * sin(moonMeanAnomaly - sunMeanAnomaly - moonMeanDistanceAcendingNode) - 1.487E-3 * sin(moonMeanDistanceAcendingNode + moonMeanElongation);
-  G_local = G_local - E_local * 1.481E-3 * sin(moonMeanDistanceAcendingNode + sunMeanAnomaly + moonMeanAnomaly) + E_local * 1.417E-3 * sin(moonMeanDistanceAcendingNode - sunMeanAnomaly - moonMeanAnomaly);
-  G_local = G_local + E_local * 1.35E-3 * sin(moonMeanDistanceAcendingNode - sunMeanAnomaly) + 1.33E-3 * sin(moonMeanDistanceAcendingNode - moonMeanElongation);
-  G_local = G_local + 1.106E-3 * sin(moonMeanDistanceAcendingNode + 3. * moonMeanAnomaly) + 1.02E-3 * sin(4. * moonMeanElongation - moonMeanDistanceAcendingNode);
-  G_local = G_local + 8.33E-4 * sin(moonMeanDistanceAcendingNode + 4 * moonMeanElongation - moonMeanAnomaly) + 7.81E-4 * sin(moonMeanAnomaly - 3. * moonMeanDistanceAcendingNode);
-  G_local = G_local + 6.7E-4 * sin(moonMeanDistanceAcendingNode + 4 * moonMeanElongation - 2. * moonMeanAnomaly) + 6.06E-4 * sin(2. * moonMeanElongation - 3. * moonMeanDistanceAcendingNode);
-  G_local = G_local + 5.97E-4 * sin(2. * (moonMeanElongation + moonMeanAnomaly) - moonMeanDistanceAcendingNode);
-  G_local = G_local + E_local * 4.92E-4 * sin(2. * moonMeanElongation + moonMeanAnomaly - sunMeanAnomaly - moonMeanDistanceAcendingNode) + 4.5E-4 * sin(2. * (moonMeanAnomaly - moonMeanElongation) - moonMeanDistanceAcendingNode);
-  G_local = G_local + 4.39E-4 * sin(3. * moonMeanAnomaly - moonMeanDistanceAcendingNode) + 4.23E-4 * sin(moonMeanDistanceAcendingNode + 2. * (moonMeanElongation + moonMeanAnomaly));
-  G_local = G_local + 4.22E-4 * sin(2. * moonMeanElongation - moonMeanDistanceAcendingNode - 3. * moonMeanAnomaly) - E_local * 3.67E-4 * sin(sunMeanAnomaly + moonMeanDistanceAcendingNode + 2. * moonMeanElongation - moonMeanAnomaly);
-  G_local = G_local - E_local * 3.53E-4 * sin(sunMeanAnomaly + moonMeanDistanceAcendingNode + 2. * moonMeanElongation) + 3.31E-4 * sin(moonMeanDistanceAcendingNode + 4 * moonMeanElongation);
-  G_local = G_local + E_local * 3.17E-4 * sin(2. * moonMeanElongation + moonMeanDistanceAcendingNode - sunMeanAnomaly + moonMeanAnomaly);
-  G_local = G_local + E2_local * 3.06E-4 * sin(2. * (moonMeanElongation - sunMeanAnomaly) - moonMeanDistanceAcendingNode) - 2.83E-4 * sin(moonMeanAnomaly + 3. * moonMeanDistanceAcendingNode);
+  double G_local = calcMoonSeries(moonLatitudeTerms, sizeof(moonLatitudeTerms) / (6 * sizeof(double)), seriesThreshold,
+    false, moonMeanElongation, sunMeanAnomaly, moonMeanAnomaly, moonMeanDistanceAcendingNode, E_local);
   double W1 = 4.664E-4 * cos(moonLongitudeAscendingNode);
   double W2 = 7.54E-5 * cos(C_local);
   moonGeocentricEclipticLatitude = deg2rad(G_local) * (1.0 - W1 - W2); // Moon's geocentric ecliptic latitude
-  moonHorizontalParallax = 9.50724E-1 + 5.1818E-2 * cos(moonMeanAnomaly) + 9.531E-3 * cos(2. * moonMeanElongation - moonMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + 7.843E-3 * cos(2. * moonMeanElongation) + 2.824E-3 * cos(2. * moonMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + 8.57E-4 * cos(2. * moonMeanElongation + moonMeanAnomaly) + E_local * 5.33E-4 * cos(2. * moonMeanElongation - sunMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + E_local * 4.01E-4 * cos(2. * moonMeanElongation - moonMeanAnomaly - sunMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + E_local * 3.2E-4 * cos(moonMeanAnomaly - sunMeanAnomaly) - 2.71E-4 * cos(moonMeanElongation);
-  moonHorizontalParallax = moonHorizontalParallax - E_local * 2.64E-4 * cos(sunMeanAnomaly + moonMeanAnomaly) - 1.98E-4 * cos(2. * moonMeanDistanceAcendingNode - moonMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + 1.73E-4 * cos(3. * moonMeanAnomaly) + 1.67E-4 * cos(4. * moonMeanElongation - moonMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax - E_local * 1.11E-4 * cos(sunMeanAnomaly) + 1.03E-4 * cos(4. * moonMeanElongation - 2. * moonMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax - 8.4E-5 * cos(2. * moonMeanAnomaly - 2. * moonMeanElongation) - E_local * 8.3E-5 * cos(2. * moonMeanElongation + sunMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + 7.9E-5 * cos(2. * moonMeanElongation + 2. * moonMeanAnomaly) + 7.2E-5 * cos(4. * moonMeanElongation);
-  moonHorizontalParallax = moonHorizontalParallax + E_local * 6.4E-5 * cos(2. * moonMeanElongation - sunMeanAnomaly + moonMeanAnomaly) - E_local * 6.3E-5 * cos(2. * moonMeanElongation + sunMeanAnomaly - moonMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + E_local * 4.1E-5 * cos(sunMeanAnomaly + moonMeanElongation) + E_local * 3.5E-5 * cos(2. * moonMeanAnomaly - sunMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax - 3.3E-5 * cos(3. * moonMeanAnomaly - 2. * moonMeanElongation) - 3E-5 * cos(moonMeanAnomaly + moonMeanElongation);
-  moonHorizontalParallax = moonHorizontalParallax - 2.9E-5 * cos(2. * (moonMeanDistanceAcendingNode - moonMeanElongation)) - E_local * 2.9E-5 * cos(2. * moonMeanAnomaly + sunMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + E2_local * 2.6E-5 * cos(2. * (moonMeanElongation - sunMeanAnomaly)) - 2.3E-5 * cos(2. * (moonMeanDistanceAcendingNode - moonMeanElongation) + moonMeanAnomaly);
-  moonHorizontalParallax = moonHorizontalParallax + E_local * 1.9E-5 * cos(4. * moonMeanElongation - sunMeanAnomaly - moonMeanAnomaly);
+  moonHorizontalParallax = 9.50724E-1 + calcMoonSeries(moonParallaxTerms, sizeof(moonParallaxTerms) / (6 * sizeof(double)),
+    seriesThreshold, true, moonMeanElongation, sunMeanAnomaly, moonMeanAnomaly, moonMeanDistanceAcendingNode, E_local);
   EquatHorizontalParallax = moonHorizontalParallax;
   moonHorizontalParallax = deg2rad(moonHorizontalParallax); // Horizntal parallax
   // end of regular routine
@@ -1147,115 +1584,170 @@ boolean SiderealPlanets::doMoon(void) {
   return true;
 }
 
+#endif
+
+#ifndef SIDEREAL_PLANETS_NO_PLANETS
+// Orbital element polynomials for doPlanetElements(), kept in flash
+static const double readData[] PROGMEM = {
+  //Mercury
+  178.179078,415.2057519,3.011e-4,0,
+  75.899697,1.5554889,2.947e-4,0,
+  2.0561421e-1,2.046e-5,-3e-8,0,
+  7.002881,1.8608e-3,-1.83e-5,0,
+  47.145944,1.1852083,1.739e-4,0,
+  3.870986e-1,6.74,-0.42,
+  //Venus
+  342.767053,162.5533664,3.097e-4,0,
+  130.163833,1.4080361,-9.764e-4,0,
+  6.82069e-3,-4.774e-5,9.1e-8,0,
+  3.393631,1.0058e-3,-1.0e-6,0,
+  75.779647,8.9985e-1,4.1e-4,0,
+  7.233316e-1,16.92,-4.4,
+  //Mars
+  293.737334,53.17137642,3.107e-4,0,
+  3.34218203e2,1.8407584,1.299e-4,-1.19e-6,
+  9.33129e-2,9.2064e-5,-7.7e-8,0,
+  1.850333,-6.75e-4,1.26e-5,0,
+  48.786442,7.709917e-1,-1.4e-6,-5.33e-6,
+  1.5236883,9.36,-1.52,
+  //Jupiter
+  238.049257,8.434172183,3.347e-4,-1.65e-6,
+  1.2720972e1,1.6099617,1.05627e-3,-3.43e-6,
+  4.833475e-2,1.6418e-4,-4.676e-7,-1.7e-9,
+  1.308736,-5.6961e-3,3.9e-6,0,
+  99.443414,1.01053,3.5222e-4,-8.51e-6,
+  5.202561,196.74,-9.4,
+  //Saturn
+  266.564377,3.398638567,3.245e-4,-5.8e-6,
+  9.1098214e1,1.9584158,8.2636e-4,4.61e-6,
+  5.589232e-2,-3.455e-4,-7.28e-7,7.4e-10,
+  2.492519,-3.9189e-3,-1.549e-5,4.0e-8,
+  112.790414,8.731951e-1,-1.5218e-4,-5.31e-6,
+  9.554747,165.6,-8.88,
+  //Uranus
+  244.19747,1.194065406,3.16e-4,-6.0e-7,
+  1.71548692e2,1.4844328,2.372e-4,-6.1e-7,
+  4.63444e-2,-2.658e-5,7.7e-8,0,
+  7.72464e-1,6.253e-4,3.95e-5,0,
+  73.477111,4.986678e-1,1.3117e-3,0,
+  19.21814,65.8,-7.19,
+  //Neptune
+  84.457994,6.107942056e-1,3.205e-4,-6.0e-7,
+  4.6727364e1,1.4245744,3.9082e-4,-6.05e-7,
+  8.99704e-3,6.33e-6,-2.0e-9,0,
+  1.779242,-9.5436e-3,-9.1e-6,0,
+  130.681389,1.098935,2.4987e-4,-4.718e-6,
+  30.10957,62.2,-6.87
+};
+
+// Read one readData[] entry, which may live in AVR program memory
+static double readElement(int k) {
+  return readTable(readData, k);
+}
+
+// Elements 7 to 9 (semi-major axis, angular diameter, magnitude) are constants,
+// so they are read straight from the table instead of being copied to RAM
+static double planetConstant(int i, int j) {
+  return readElement((i - 1) * 23 + 13 + j);
+}
+
 boolean SiderealPlanets::doPlanetElements(void) {
-  // 'i' in planetaryOrbitalElements[i][j] is the number of the planet to compute
+  // 'i' in PL(i, j) is the number of the planet to compute, 'j' the element
   // 1=Mercury, 2=Venus, 3=Mars, 4=Jupiter, 5=Saturn, 6=Uranus, 7=Neptune
-  const double readData[] = {
-    //Mercury
-    178.179078,415.2057519,3.011e-4,0,
-	75.899697,1.5554889,2.947e-4,0,
-	2.0561421e-1,2.046e-5,-3e-8,0,
-	7.002881,1.8608e-3,-1.83e-5,0,
-	47.145944,1.1852083,1.739e-4,0,
-	3.870986e-1,6.74,-0.42,
-	//Venus
-	342.767053,162.5533664,3.097e-4,0,
-	130.163833,1.4080361,-9.764e-4,0,
-	6.82069e-3,-4.774e-5,9.1e-8,0,
-	3.393631,1.0058e-3,-1.0e-6,0,
-	75.779647,8.9985e-1,4.1e-4,0,
-	7.233316e-1,16.92,-4.4,
-	//Mars
-	293.737334,53.17137642,3.107e-4,0,
-	3.34218203e2,1.8407584,1.299e-4,-1.19e-6,
-	9.33129e-2,9.2064e-5,-7.7e-8,0,
-	1.850333,-6.75e-4,1.26e-5,0,
-	48.786442,7.709917e-1,-1.4e-6,-5.33e-6,
-	1.5236883,9.36,-1.52,
-	//Jupiter
-	238.049257,8.434172183,3.347e-4,-1.65e-6,
-	1.2720972e1,1.6099617,1.05627e-3,-3.43e-6,
-	4.833475e-2,1.6418e-4,-4.676e-7,-1.7e-9,
-	1.308736,-5.6961e-3,3.9e-6,0,
-	99.443414,1.01053,3.5222e-4,-8.51e-6,
-	5.202561,196.74,-9.4,
-	//Saturn
-	266.564377,3.398638567,3.245e-4,-5.8e-6,
-	9.1098214e1,1.9584158,8.2636e-4,4.61e-6,
-	5.589232e-2,-3.455e-4,-7.28e-7,7.4e-10,
-	2.492519,-3.9189e-3,-1.549e-5,4.0e-8,
-	112.790414,8.731951e-1,-1.5218e-4,-5.31e-6,
-	9.554747,165.6,-8.88,
-	//Uranus
-	244.19747,1.194065406,3.16e-4,-6.0e-7,
-	1.71548692e2,1.4844328,2.372e-4,-6.1e-7,
-	4.63444e-2,-2.658e-5,7.7e-8,0,
-	7.72464e-1,6.253e-4,3.95e-5,0,
-	73.477111,4.986678e-1,1.3117e-3,0,
-	19.21814,65.8,-7.19,
-	//Neptune
-	84.457994,6.107942056e-1,3.205e-4,-6.0e-7,
-	4.6727364e1,1.4245744,3.9082e-4,-6.05e-7,
-	8.99704e-3,6.33e-6,-2.0e-9,0,
-	1.779242,-9.5436e-3,-9.1e-6,0,
-	130.681389,1.098935,2.4987e-4,-4.718e-6,
-	30.10957,62.2,-6.87
-  };
+  // (Stored as planetaryOrbitalElements[i - 1][j - 1]; PL(i, j) does the offset)
   julianCenturies1900 = (modifiedJulianDate1900() / 36525.0) + (getGMT() / 8.766e5);
   double A0_local, A1_local, A2_local, A3_local, AA_local, B_local;
   int i, j, k;
   k = 0; //data array index
   for (i = 1; i < 8; i++) {
-	A0_local = readData[k++];
-	A1_local = readData[k++];
-	A2_local = readData[k++];
-	A3_local = readData[k++];
+	A0_local = readElement(k++);
+	A1_local = readElement(k++);
+	A2_local = readElement(k++);
+	A3_local = readElement(k++);
 	AA_local = A1_local * julianCenturies1900;
 	B_local = 360.0 * (AA_local - floor(AA_local));
-	planetaryOrbitalElements[i][1] = inRange360(A0_local + B_local + (A3_local * julianCenturies1900 + A2_local) * julianCenturies1900 * julianCenturies1900);
-	planetaryOrbitalElements[i][2] = (A1_local * 9.856263e-3) + (A2_local + A3_local) / 36525.0;
+	PL(i, 1) = inRange360(A0_local + B_local + (A3_local * julianCenturies1900 + A2_local) * julianCenturies1900 * julianCenturies1900);
+	PL(i, 2) = (A1_local * 9.856263e-3) + (A2_local + A3_local) / 36525.0;
 	for (j = 3; j <= 6; j++) {
-	  A0_local = readData[k++];
-	  A1_local = readData[k++];
-	  A2_local = readData[k++];
-	  A3_local = readData[k++];
-	  planetaryOrbitalElements[i][j] = ((A3_local * julianCenturies1900 + A2_local) * julianCenturies1900 + A1_local) * julianCenturies1900 + A0_local;
+	  A0_local = readElement(k++);
+	  A1_local = readElement(k++);
+	  A2_local = readElement(k++);
+	  A3_local = readElement(k++);
+	  PL(i, j) = ((A3_local * julianCenturies1900 + A2_local) * julianCenturies1900 + A1_local) * julianCenturies1900 + A0_local;
 	}
-	planetaryOrbitalElements[i][7] = readData[k++];
-	planetaryOrbitalElements[i][8] = readData[k++];
-	planetaryOrbitalElements[i][9] = readData[k++];
+	k += 3; // Elements 7 to 9, see planetConstant()
   }
   return true;
 }
 
 double SiderealPlanets::getPL(int i, int j) {
   // get orbital element j for a planet i
-  return planetaryOrbitalElements[i][j];
+  if (i < 1 || i > 7 || j < 1 || j > 9) return 0.; //bad index
+  if (j > 6) return planetConstant(i, j);
+  return PL(i, j);
 }
 
 boolean SiderealPlanets::doPlans(int planetNumber) {
   //Calculate apparent geocentric ecliptic coordinates,
   //allowing for light travel time, for the planets
-  int K_local, J_local;
+  SiderealPlanetState state;
+  if (startPlanet(planetNumber, state) == false) return false; //bad planet value
+  while (doPlanetStep(state)) ;
+  return true;
+}
+
+// Start a planet position that doPlanetStep() then works out one stage at a
+// time: the Sun and orbital elements, each light time pass, and the apparent
+// position.  The date and time must not change until state.done is true.
+boolean SiderealPlanets::startPlanet(int planetNumber, SiderealPlanetState &state) {
+  if (planetNumber < 1 || planetNumber > 7) return false; //bad planet value
+  state.planet = planetNumber;
+  state.step = 0;
+  // The second pass corrects for light time, up to about half an arc minute
+  state.passes = (accuracy == SP_ACCURACY_FULL) ? 2 : 1;
+  state.lightTravelTime = 0.;
+  state.done = false;
+  return true;
+}
+
+// Run the next stage.  Returns false once the position is done; the results
+// are then read as after doPlans().
+boolean SiderealPlanets::doPlanetStep(SiderealPlanetState &state) {
+  if (state.done) return false;
+  byte step = state.step++;
+  if (step == 0) {
+    doMoonDone = false;
+    doPlanetElements();
+    doSun();
+    state.sunMeanAnomaly = SP_meanAnomaly; // SP_meanAnomaly is Mean Anomaly of the Sun in radians
+    state.radiusVectorEarth = sunEarthDistance;
+    state.earthEclipticLongitude = sunTrueGeocentricLongitude + FPI; //Earth's ecliptic longitude (radians)
+  } else if (step <= state.passes) {
+    doPlanetPass(state, step);
+  } else {
+    doPlanetPosition(state);
+    state.done = true;
+  }
+  return true;
+}
+
+// One pass of the planet's heliocentric orbit, perturbations included, at
+// the light time found by the pass before
+void SiderealPlanets::doPlanetPass(SiderealPlanetState &state, int pass) {
+  int J_local;
+  int planetNumber = state.planet;
   double perturbationLongitude, perturbationRadiusVector, perturbationMeanLongitude, perturbationEccentricity, perturbationMeanAnomaly, perturbationSemiMajorAxis, perturbationHeliocentricEclipticLatitude;
-  double sunMeanAnomaly, radiusVectorEarth, earthEclipticLongitude, SP_eccentricity;
+  double sunMeanAnomaly = state.sunMeanAnomaly, radiusVectorEarth = state.radiusVectorEarth;
+  double earthEclipticLongitude = state.earthEclipticLongitude, SP_eccentricity;
   double planetAnomalies[8];
-  double radiusVectorCorrected, LO_local, LP_local, LongitudeAscendingNode, CO_local, inclination, SO_local, SP_local, Y_local, PS_local, PD_local, cosine_PS_local, RD_local, LL_local, distanceEarthCorrected, L1_local, L2_local, geocentricEclipticLongitude, geocentricEclipticLatitude, A_local;
+  double lightTravelTime = state.lightTravelTime;
+  double radiusVectorCorrected, LO_local, LP_local, LongitudeAscendingNode, CO_local, inclination, SO_local, SP_local, Y_local, PS_local, PD_local, cosine_PS_local, RD_local, LL_local, distanceEarthCorrected, A_local;
   double SA_local, CA_local, J1_local, J2_local, J3_local, J4_local, J5_local, J6_local, J7_local, J8_local, J9_local, JA_local, JB_local, JC_local;
   double  U1_local, U2_local, U3_local, U4_local, U5_local, U6_local, U7_local, U8_local, U9_local, UA_local, UB_local, UC_local, UD_local, UE_local, UF_local, UG_local, UI_local, UJ_local, UK_local, UL_local, UN_local, UO_local, UP_local, UQ_local, UR_local, UU_local, UV_local, UW_local, UX_local, UY_local, UZ_local;
   double  VA_local, VB_local, VC_local, VD_local, VE_local, VF_local, VG_local, VH_local, VI_local, VJ_local, VK_local;
   
-  if (planetNumber < 1 || planetNumber > 7) return false; //bad planet value
-  doMoonDone = false;
-  doPlanetElements();
-  double lightTravelTime = 0.;
-  doSun();
-  sunMeanAnomaly = SP_meanAnomaly; // SP_meanAnomaly is Mean Anomaly of the Sun in radians
-  radiusVectorEarth = sunEarthDistance;
-  earthEclipticLongitude = sunTrueGeocentricLongitude + FPI; //Earth's ecliptic longitude (radians)
-  for (K_local = 1; K_local < 3; K_local++) {
 	for (J_local = 1; J_local < 8; J_local++) {
-	  planetAnomalies[J_local] = deg2rad(planetaryOrbitalElements[J_local][1] - planetaryOrbitalElements[J_local][3] - lightTravelTime * planetaryOrbitalElements[J_local][2]);
+	  planetAnomalies[J_local] = deg2rad(PL(J_local, 1) - PL(J_local, 3) - lightTravelTime * PL(J_local, 2));
 	}
 	perturbationLongitude = 0.;
 	perturbationRadiusVector = 0.;
@@ -1264,7 +1756,9 @@ boolean SiderealPlanets::doPlans(int planetNumber) {
 	perturbationMeanAnomaly = 0.;
 	perturbationSemiMajorAxis = 0.;
 	perturbationHeliocentricEclipticLatitude = 0.;
-	if (planetNumber == 1) {
+	if (planetNumber <= 3 && accuracy == SP_ACCURACY_DEGREE) {
+      //Mercury, Venus and Mars terms are all under 0.012 degrees
+	} else if (planetNumber == 1) {
       //Mercury
 	  perturbationLongitude = 2.04e-3 * cos(5. * planetAnomalies[2] - 2. * planetAnomalies[1] + 2.1328e-1);
 	  perturbationLongitude = perturbationLongitude + 1.03e-3 * cos(2. * planetAnomalies[2] - planetAnomalies[1] - 2.08046);
@@ -1399,7 +1893,7 @@ boolean SiderealPlanets::doPlans(int planetNumber) {
 		VK_local = VK_local + 2.722e-3 * UB_local * U3_local + 4.483e-3 * UA_local * U3_local;
 		VK_local = VK_local - 2.642e-3 * UC_local * U3_local + 4.403e-3 * U9_local * U4_local;
 		VK_local = VK_local - 2.536e-3 * UB_local * U4_local + 5.547e-3 * UA_local * U4_local - 2.689e-3 * UC_local * U4_local;
-		perturbationMeanAnomaly = perturbationMeanLongitude - (deg2rad(VK_local) / planetaryOrbitalElements[planetNumber][4]);
+		perturbationMeanAnomaly = perturbationMeanLongitude - (deg2rad(VK_local) / PL(planetNumber, 4));
 		
 		perturbationSemiMajorAxis = 205. * UA_local - 263. * U6_local + 693. * UC_local + 312. * UE_local + 147. * UG_local + 299. * U9_local * U1_local;
 		perturbationSemiMajorAxis = perturbationSemiMajorAxis + 181. * UC_local * U1_local + 204. * UB_local * U2_local + 111. * UD_local * U2_local - 337. * UA_local * U2_local;
@@ -1464,7 +1958,7 @@ boolean SiderealPlanets::doPlans(int planetNumber) {
 		VK_local = VK_local - (1.3667e-2 - 1.239e-3 * J1_local) * U9_local * U4_local;
 		VK_local = VK_local + (1.4861e-2 + 1.136e-3 * J1_local) * UA_local * U4_local;
 		VK_local = VK_local - (1.3064e-2 + 1.628e-3 * J1_local) * UC_local * U4_local;
-		perturbationMeanAnomaly = perturbationMeanLongitude - (deg2rad(VK_local) / planetaryOrbitalElements[planetNumber][4]);
+		perturbationMeanAnomaly = perturbationMeanLongitude - (deg2rad(VK_local) / PL(planetNumber, 4));
 		perturbationSemiMajorAxis = 572. * U5_local - 1590. * UB_local * U2_local + 2933. * U6_local - 647. * UD_local * U2_local;
 		perturbationSemiMajorAxis = perturbationSemiMajorAxis + 33629. * UA_local - 344. * UF_local * U2_local - 3081. * UC_local + 2885. * UA_local * U2_local;
 		perturbationSemiMajorAxis = perturbationSemiMajorAxis - 1423. * UE_local + (2172. + 102. * J1_local) * UC_local * U2_local - 671. * UG_local;
@@ -1491,7 +1985,7 @@ boolean SiderealPlanets::doPlans(int planetNumber) {
 		perturbationMeanLongitude = deg2rad(perturbationMeanLongitude);
 		VK_local = 1.20303e-1 * VJ_local + 6.197e-3 * UV_local;
 		VK_local = VK_local + (1.9472e-2 - 9.47e-4 * J1_local) * UU_local;
-		perturbationMeanAnomaly = perturbationMeanLongitude - (deg2rad(VK_local) / planetaryOrbitalElements[planetNumber][4]);
+		perturbationMeanAnomaly = perturbationMeanLongitude - (deg2rad(VK_local) / PL(planetNumber, 4));
 		perturbationEccentricity = (163. * J1_local - 3349.) * VJ_local + 20981. * UU_local + 1311. * UW_local;
 		perturbationEccentricity = perturbationEccentricity * 1.0e-7;
 		perturbationSemiMajorAxis = -3.825e-3 * UU_local;
@@ -1531,7 +2025,7 @@ boolean SiderealPlanets::doPlans(int planetNumber) {
 		VK_local = 2.4039e-2 * VJ_local - 2.5303e-2 * UU_local + 6.206e-3 * UV_local;
 		
 		VK_local = VK_local - 5.992e-3 * UW_local;
-		perturbationMeanAnomaly = perturbationMeanLongitude - (deg2rad(VK_local) / planetaryOrbitalElements[planetNumber][4]);
+		perturbationMeanAnomaly = perturbationMeanLongitude - (deg2rad(VK_local) / PL(planetNumber, 4));
 		perturbationEccentricity = 4389. * VJ_local + 1129. * UV_local + 4262. * UU_local + 1089. * UW_local;
 		perturbationEccentricity = perturbationEccentricity * 1.0e-7;
 		perturbationSemiMajorAxis = 8189. * UU_local - 817. * VJ_local + 781. * UW_local;
@@ -1549,17 +2043,17 @@ boolean SiderealPlanets::doPlans(int planetNumber) {
 		perturbationRadiusVector = perturbationRadiusVector * 1.0e-6;
 	  }
 	}
-	SP_eccentricity = planetaryOrbitalElements[planetNumber][4] + perturbationEccentricity;
+	SP_eccentricity = PL(planetNumber, 4) + perturbationEccentricity;
 	SP_meanAnomaly = planetAnomalies[planetNumber] + perturbationMeanAnomaly;
 	doAnomaly(rad2deg(SP_meanAnomaly), SP_eccentricity);
-	radiusVectorCorrected = (planetaryOrbitalElements[planetNumber][7] + perturbationSemiMajorAxis) * (1.0 - SP_eccentricity * SP_eccentricity) / (1.0 + SP_eccentricity * cos(trueAnomaly));
-	LP_local = rad2deg(trueAnomaly) + planetaryOrbitalElements[planetNumber][3] + rad2deg(perturbationMeanLongitude - perturbationMeanAnomaly);
+	radiusVectorCorrected = (planetConstant(planetNumber, 7) + perturbationSemiMajorAxis) * (1.0 - SP_eccentricity * SP_eccentricity) / (1.0 + SP_eccentricity * cos(trueAnomaly));
+	LP_local = rad2deg(trueAnomaly) + PL(planetNumber, 3) + rad2deg(perturbationMeanLongitude - perturbationMeanAnomaly);
 	LP_local = deg2rad(LP_local);
-	LongitudeAscendingNode = deg2rad(planetaryOrbitalElements[planetNumber][6]);
+	LongitudeAscendingNode = deg2rad(PL(planetNumber, 6));
 	LO_local = LP_local - LongitudeAscendingNode;
 	SO_local = sin(LO_local);
 	CO_local = cos(LO_local);
-	inclination = deg2rad(planetaryOrbitalElements[planetNumber][5]);
+	inclination = deg2rad(PL(planetNumber, 5));
 	radiusVectorCorrected = radiusVectorCorrected + perturbationRadiusVector;
 	SP_local = SO_local * sin(inclination);
 	Y_local = SO_local * cos(inclination);
@@ -1573,14 +2067,27 @@ boolean SiderealPlanets::doPlans(int planetNumber) {
 	LL_local = PD_local - earthEclipticLongitude;
 	distanceEarthCorrected = radiusVectorEarth * radiusVectorEarth + radiusVectorCorrected * radiusVectorCorrected - 2.0 * radiusVectorEarth * radiusVectorCorrected * cosine_PS_local * cos(LL_local);
 	distanceEarthCorrected = sqrt(distanceEarthCorrected); //Earth-planet distance in azimuthRising
-	lightTravelTime = distanceEarthCorrected * 5.775518e-3;
-	if (K_local == 1) {
+	state.lightTravelTime = distanceEarthCorrected * 5.775518e-3;
+	if (pass == 1) {
       heliocenttricEclipticLongitude = PD_local; //heliocentric ecliptic longitude (radians)
 	  distanceEarthNotCorrected = distanceEarthCorrected; //distance from Earth in azimuthRising
 	  heliocenttricEclipticLatitude = PS_local; //heliocentric latitude in radians
 	  radiusVectorPlanet = radiusVectorCorrected; //radius vector (azimuthRising)
 	}
-  }
+	state.RD = RD_local;
+	state.LL = LL_local;
+	state.PD = PD_local;
+	state.sinPS = SP_local;
+	state.cosPS = cosine_PS_local;
+}
+
+// Geocentric position from the last pass, then nutation and aberration
+void SiderealPlanets::doPlanetPosition(const SiderealPlanetState &state) {
+  int planetNumber = state.planet;
+  double radiusVectorEarth = state.radiusVectorEarth, earthEclipticLongitude = state.earthEclipticLongitude;
+  double RD_local = state.RD, LL_local = state.LL, PD_local = state.PD;
+  double SP_local = state.sinPS, cosine_PS_local = state.cosPS;
+  double L1_local, L2_local, geocentricEclipticLongitude, geocentricEclipticLatitude, A_local;
 
   L1_local = sin(LL_local);
   L2_local = cos(LL_local);
@@ -1608,7 +2115,6 @@ boolean SiderealPlanets::doPlans(int planetNumber) {
   doEcliptic2RAdec();
   EclLongitude = EPtemp;
   EclLatitude = BPtemp;
-  return true;
 }
 
 double SiderealPlanets::getHelioLong(void) {
@@ -1662,136 +2168,191 @@ boolean SiderealPlanets::doNeptune(void) {
   return true;
 }
 
-boolean SiderealPlanets::doSunRiseSetTimes(void) {
-  double horizonVerticalDisplacement = 1.454441e-2;
-  double tmpGMT = GMTtime;
-  GMTtime = (12.0 + (TimeZoneOffset + DSToffset));
-  doSun();
-  GMTtime = tmpGMT;
-  if (doRiseSetTimes(rad2deg(horizonVerticalDisplacement)) == false) return false;
-  
-  double LA_local = localSiderealTimeRising; //localSiderealTime of rising - first guesstimate
-  double LB_local = localSiderealTimeSetting; //localSiderealTime of setting - first guesstimate
-  double GU_local = doLST2GMT(LA_local);
-  double GD_local = doLST2GMT(LB_local);
-  
-  GMTtime = GU_local;
-  double DN_local = mjd1900;
-  double A_local = GMTtime + TimeZoneOffset + DSToffset;
-  if (A_local > 24.) mjd1900 -= 1;
-  if (A_local < 0.)  mjd1900 += 1;
-  doSun();
-  mjd1900 = DN_local;
-  GMTtime = tmpGMT;
-  if (doRiseSetTimes(rad2deg(horizonVerticalDisplacement)) == false) return false;
-  LA_local = localSiderealTimeRising; //AA_local = azimuthRising;
-  
-  GMTtime = GD_local;
-  A_local = GMTtime + TimeZoneOffset + DSToffset;
-  if (A_local > 24.) mjd1900 -= 1;
-  if (A_local < 0.)  mjd1900 += 1;
-  doSun();
-  mjd1900 = DN_local;
-  GMTtime = tmpGMT;
-  if (doRiseSetTimes(rad2deg(horizonVerticalDisplacement)) == false) return false;
-  
-  LB_local = localSiderealTimeSetting; //AB_local = azimuthSetting;
-  localSiderealTimeRising = LA_local;
+#endif
+
+double SiderealPlanets::getEarthHelioLong(void) {
+  // Earth's heliocentric ecliptic longitude from the last doSun() or doPlans()
+  return rad2deg(inRange2PI(sunTrueGeocentricLongitude + FPI));
+}
+
+double SiderealPlanets::getEarthRadiusVec(void) {
+  return (sunEarthDistance);
+}
+
+boolean SiderealPlanets::doBody(int body) {
+  // Compute any body by number, so that batch code can loop over bodies.
+  // Bodies left out of the build return false, as bad values do.
+  if (body == SP_SUN) {
+    doSun();
+#ifndef SIDEREAL_PLANETS_NO_MOON
+  } else if (body == SP_MOON) {
+    doMoon();
+#endif
+  } else {
+#ifdef SIDEREAL_PLANETS_NO_PLANETS
+    return false; //bad body value
+#else
+    if (doPlans(body) == false) return false; //bad body value
+#endif
+  }
+  lastBody = body;
   return true;
 }
 
-double SiderealPlanets::getSunriseTime(void) {
-  return getRiseTime();
+double SiderealPlanets::getBodyDistance(void) {
+  // Distance from Earth in AU for the body of the last doBody() call
+  if (lastBody == SP_SUN) return sunEarthDistance;
+#ifndef SIDEREAL_PLANETS_NO_MOON
+  if (lastBody == SP_MOON) return 4.263523e-5 / sin(moonHorizontalParallax); //Earth radius in AU
+#endif
+#ifdef SIDEREAL_PLANETS_NO_PLANETS
+  return 0.;
+#else
+  return distanceEarthNotCorrected;
+#endif
 }
 
-double SiderealPlanets::getSunsetTime(void) {
-  return getSetTime();
+// Trade accuracy for speed: SP_ACCURACY_FULL (the default),
+// SP_ACCURACY_ARCMINUTE or SP_ACCURACY_DEGREE.  See the table in README.md.
+boolean SiderealPlanets::setAccuracy(int tier) {
+  if (tier < SP_ACCURACY_FULL || tier > SP_ACCURACY_DEGREE) return false; //bad input
+  if (accuracy == tier) return true; //Already did it
+  accuracy = tier;
+  nutationDone = false;
+  doMoonDone = false;
+  return true;
 }
 
-boolean SiderealPlanets::doMoonRiseSetTimes(void) {
-  double DN_local, horizonVerticalDisplacement, A_local, TH_local, AA_local, AB_local;
-  double GU_local = 0.;
-  double GD_local = 0.;
-  double G1_local = 0.;
-  double G2_local = 0.;
-  double tmpGMT = GMTtime;
-  GMTtime = (12.0 + (TimeZoneOffset + DSToffset)); //Set to local mid-day
-
-  //local rise-set routine
-  doMoon(); //Already does nutation too
-  TH_local = 2.7249e-1 * sin(moonHorizontalParallax);
-  horizonVerticalDisplacement = TH_local + 9.8902e-3 - moonHorizontalParallax;
-  // return if moon doesn't cross horizon
-  if (doRiseSetTimes(rad2deg(horizonVerticalDisplacement)) == false) {
-	  GMTtime = tmpGMT;
-	  return false;
-  }
+int SiderealPlanets::getAccuracy(void) {
+  return accuracy;
+}
 
-  moonRiseValidFlag = true;
-  moonSetValidFlag = true;
-  double LA_local = localSiderealTimeRising; //localSiderealTime of rising - first guesstimate
-  double LB_local = localSiderealTimeSetting; //localSiderealTime of setting - first guesstimate
-
-  for (int K_local=1; K_local <= 3; K_local++) {
-	G1_local = GU_local;
-    // local sidereal time to local civil time
-    GU_local = doLST2GMT(LA_local);
-
-    G2_local = GD_local;
-    // local sidereal time to local civil time
-    GD_local = doLST2GMT(LB_local);
-
-    //find a better time of rising
-    GMTtime = GU_local;
-    // find time
-    DN_local = mjd1900;
-    A_local = GMTtime + TimeZoneOffset + DSToffset;
-    if (A_local > 24.) mjd1900 -= 1;
-    if (A_local < 0.) mjd1900 += 1;
-    //local rise-set routine
-    doMoon(); //Already does nutation too
-    TH_local = 2.7249e-1 * sin(moonHorizontalParallax);
-    horizonVerticalDisplacement = TH_local + 9.8902e-3 - moonHorizontalParallax;
-    if (doRiseSetTimes(rad2deg(horizonVerticalDisplacement)) == false) {
-      mjd1900 = DN_local;
-      GMTtime = tmpGMT;
-      return false;
+#ifndef SIDEREAL_PLANETS_NO_RISESET
+boolean SiderealPlanets::doSunRiseSetTimes(void) {
+  SiderealRiseSetState state;
+  startRiseSet(SP_SUN, state);
+  while (doRiseSetStep(state)) ;
+  return state.found;
+}
+
+// Start a rise/set search for SP_SUN or SP_MOON that doRiseSetStep() then
+// runs one evaluation at a time: 3 doSun() or 7 doMoon() calls.  The date,
+// time and site must not change until state.done is true.
+boolean SiderealPlanets::startRiseSet(int body, SiderealRiseSetState &state) {
+#ifdef SIDEREAL_PLANETS_NO_MOON
+  if (body != SP_SUN) return false; //bad body value
+#else
+  if (body != SP_SUN && body != SP_MOON) return false; //bad body value
+#endif
+  state.riseLST = state.setLST = 0.;
+  state.riseGMT = state.setGMT = 0.;
+  state.lastRiseGMT = state.lastSetGMT = 0.;
+  state.body = body;
+  state.step = 0;
+  state.done = false;
+  state.found = false;
+  return true;
+}
+
+// Run the next evaluation of the search.  Returns false once it is done, with
+// state.found as doSunRiseSetTimes() or doMoonRiseSetTimes() would return.
+boolean SiderealPlanets::doRiseSetStep(SiderealRiseSetState &state) {
+  if (state.done) return false;
+  byte step = state.step++;
+  // After the guess from local mid-day, the Sun refines its rising then its
+  // setting once; the Moon refines both three times, rising on odd steps
+  byte lastStep = (state.body == SP_SUN) ? 2 : 6;
+  boolean rising = (state.body == SP_SUN) ? (step == 1) : ((step & 1) == 1);
+  double gmt = 12.0 + (TimeZoneOffset + DSToffset);
+  if (step > 0) {
+    if (state.body != SP_SUN && rising) {
+      // local sidereal time to local civil time
+      state.lastRiseGMT = state.riseGMT;
+      state.riseGMT = doLST2GMT(state.riseLST);
+      state.lastSetGMT = state.setGMT;
+      state.setGMT = doLST2GMT(state.setLST);
     }
-    mjd1900=DN_local;
-    //find a better time of setting
-    LA_local = localSiderealTimeRising;
-    //AA_local = azimuthRising;
-    GMTtime = GD_local;
-    // find time
-    DN_local = mjd1900;
-    A_local = GMTtime + TimeZoneOffset + DSToffset;
+    gmt = rising ? state.riseGMT : state.setGMT;
+  }
+  if (calcRiseSetAt(state.body, gmt, step > 0) == false) {
+    state.done = true; // doesn't cross the horizon
+    return true;
+  }
+  if (step == 0) {
+    state.riseLST = localSiderealTimeRising; //localSiderealTime of rising - first guesstimate
+    state.setLST = localSiderealTimeSetting; //localSiderealTime of setting - first guesstimate
+    if (state.body == SP_SUN) {
+      state.riseGMT = doLST2GMT(state.riseLST);
+      state.setGMT = doLST2GMT(state.setLST);
+    }
+#ifndef SIDEREAL_PLANETS_NO_MOON
+    if (state.body == SP_MOON) {
+      moonRiseValidFlag = true;
+      moonSetValidFlag = true;
+    }
+#endif
+    return true;
+  }
+  if (rising) {
+    state.riseLST = localSiderealTimeRising;
+  } else {
+    state.setLST = localSiderealTimeSetting;
+  }
+  if (step < lastStep) return true;
+#ifndef SIDEREAL_PLANETS_NO_MOON
+  if (state.body == SP_MOON) {
+    if (fabs(state.riseGMT - state.lastRiseGMT) > 6.0) moonRiseValidFlag = false;
+    if (fabs(state.setGMT - state.lastSetGMT) > 6.0) moonSetValidFlag = false;
+  }
+#endif
+  localSiderealTimeRising = state.riseLST;
+  localSiderealTimeSetting = state.setLST;
+  state.done = true;
+  state.found = true;
+  return true;
+}
+
+// Private: compute the Sun or Moon at gmt hours on the current date, a day
+// earlier or later if shift is set and that is another local day, then find
+// its rise and set sidereal times.  The date and time are put back.
+boolean SiderealPlanets::calcRiseSetAt(int body, double gmt, boolean shift) {
+  double tmpGMT = GMTtime;
+  double DN_local = mjd1900;
+  GMTtime = gmt;
+  if (shift) {
+    double A_local = GMTtime + TimeZoneOffset + DSToffset;
     if (A_local > 24.) mjd1900 -= 1;
     if (A_local < 0.) mjd1900 += 1;
-    //local rise-set routine
+  }
+  double horizonVerticalDisplacement = 1.454441e-2;
+  if (body == SP_SUN) {
+    doSun();
+#ifndef SIDEREAL_PLANETS_NO_MOON
+  } else {
     doMoon(); //Already does nutation too
-    TH_local = 2.7249e-1 * sin(moonHorizontalParallax);
+    double TH_local = 2.7249e-1 * sin(moonHorizontalParallax);
     horizonVerticalDisplacement = TH_local + 9.8902e-3 - moonHorizontalParallax;
-    if (doRiseSetTimes(rad2deg(horizonVerticalDisplacement)) == false) {
-      mjd1900 = DN_local;
-      GMTtime = tmpGMT;
-      return false;
-    }
-    mjd1900=DN_local;
-    LB_local = localSiderealTimeSetting;
-    //AB_local = azimuthSetting;
-  }
-  //azimuthRising = AA_local;
-  //azimuthSetting = AB_local;
-  if ( fabs( GU_local - G1_local ) > 6.0 ) {
-    moonRiseValidFlag = false;
-  }
-  localSiderealTimeRising = LA_local;
-  if ( fabs( GD_local - G2_local ) > 6.0 ) {
-    moonSetValidFlag = false;
+#endif
   }
-  localSiderealTimeSetting = LB_local;
+  if (shift) mjd1900 = DN_local;
   GMTtime = tmpGMT;
-  return true;
+  return doRiseSetTimes(rad2deg(horizonVerticalDisplacement));
+}
+
+double SiderealPlanets::getSunriseTime(void) {
+  return getRiseTime();
+}
+
+double SiderealPlanets::getSunsetTime(void) {
+  return getSetTime();
+}
+
+#ifndef SIDEREAL_PLANETS_NO_MOON
+boolean SiderealPlanets::doMoonRiseSetTimes(void) {
+  SiderealRiseSetState state;
+  startRiseSet(SP_MOON, state);
+  while (doRiseSetStep(state)) ;
+  return state.found;
 }
 
 boolean SiderealPlanets::getMoonRiseValidFlag(void) {
@@ -1809,6 +2370,8 @@ boolean SiderealPlanets::getMoonSetValidFlag(void) {
 double SiderealPlanets::getMoonsetTime(void) {
   return getSetTime();
 }
+#endif // SIDEREAL_PLANETS_NO_MOON
+#endif // SIDEREAL_PLANETS_NO_RISESET
 
 void SiderealPlanets::printDegMinSecs(double n) {
   boolean sign = (n < 0.);
@@ -1817,8 +2380,12 @@ void SiderealPlanets::printDegMinSecs(double n) {
   long deg = lsec / 360000;
   long min = (lsec - (deg * 360000)) / 6000;
   float secs = (lsec - (deg * 360000) - (min * 6000)) / 100.;
+#ifdef SIDEREAL_PLANETS_HOST
+  printf("%s%ld:%ld:%.2f ", sign ? "-" : "", deg, min, (double)fabs(secs));
+#else
   if (sign) Serial.print("-");
   Serial.print(deg); Serial.print(":");
   Serial.print(min); Serial.print(":");
   Serial.print(abs(secs)); Serial.print(" ");
+#endif
 }
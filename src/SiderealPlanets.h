@@ -30,15 +30,63 @@ TODO:
 //Uncomment the following line for debugging output
 //#define debug_sidereal_planets
 
+// Subsystems a sketch does not use can be left out, to save flash and RAM on
+// small boards.  Time, coordinate conversion, nutation and the Sun are always
+// built.  Uncomment any of these lines, or pass them as build flags (such as
+// PlatformIO build_flags).  README.md lists the savings.
+//#define SIDEREAL_PLANETS_NO_MOON       // doMoon(), lunar phases, doMoonRiseSetTimes()
+//#define SIDEREAL_PLANETS_NO_PLANETS    // doPlans(), doMercury() to doNeptune()
+//#define SIDEREAL_PLANETS_NO_PRECESSION // doPrecessFrom2000(), doPrecessTo2000()
+//#define SIDEREAL_PLANETS_NO_REFRACTION // doRefractionC() and the like, SiderealRefraction,
+                                         // SiderealAirmass and SiderealSolarField
+//#define SIDEREAL_PLANETS_NO_RISESET    // doRiseSetTimes(), doSunRiseSetTimes(), doMoonRiseSetTimes()
+
 #include <stdint.h>
 #include <math.h>
+#include "SiderealMath.h"
 
 #if defined(ARDUINO) && ARDUINO >= 100
   #include "Arduino.h"
-#else
+#elif defined(ARDUINO)
   #include "WProgram.h"
+#else
+  // Host build (desktop or server), so supply the few Arduino types we use
+  #define SIDEREAL_PLANETS_HOST
+  #include <stdio.h>
+  #include <stdlib.h>
+  typedef bool boolean;
+  typedef uint8_t byte;
+  #define PROGMEM
+  #define pgm_read_byte(addr) (*(const unsigned char *)(addr))
 #endif
 
+// Threaded helpers (SiderealScheduler) need std::thread, which the host has.
+// Boards with a threaded C++ runtime can define this before including us.
+#if defined(SIDEREAL_PLANETS_HOST) && !defined(SIDEREAL_PLANETS_THREADS)
+  #define SIDEREAL_PLANETS_THREADS
+#endif
+
+// Body numbers used by doBody(). The planets match the doPlans() numbering.
+enum SiderealBody {
+  SP_SUN = 0,
+  SP_MERCURY = 1,
+  SP_VENUS = 2,
+  SP_MARS = 3,
+  SP_JUPITER = 4,
+  SP_SATURN = 5,
+  SP_URANUS = 6,
+  SP_NEPTUNE = 7,
+  SP_MOON = 8
+};
+
+// Accuracy tiers for setAccuracy().  Lower tiers drop the smaller terms of
+// the Moon and nutation series and the planets' light time correction.
+enum SiderealAccuracy {
+  SP_ACCURACY_FULL = 0,      // every term, the arc second class
+  SP_ACCURACY_ARCMINUTE = 1, // terms of 0.001 degrees and up
+  SP_ACCURACY_DEGREE = 2     // terms of 0.03 degrees and up
+};
+
 // Structure to hold data
 // We need to populate this when we calculate data
 struct SiderealPlanetsData {
@@ -56,6 +104,96 @@ struct SiderealPlanetsData {
 	double Azimuth;
 };
 
+// GMT calendar date and time of one sample
+struct SiderealEpoch {
+  int year;
+  int month;
+  int day;
+  int hour;
+  int minute;
+  float seconds;
+};
+
+// Observer location: degrees, with elevation in meters
+struct SiderealSite {
+  double latitude;
+  double longitude;
+  double elevation;
+};
+
+// Computed position of a body: RA in hours, angles in degrees, distance in AU
+struct SiderealPosition {
+  double rightAscension;
+  double declination;
+  double altitude;
+  double azimuth;
+  double distance;
+};
+
+// A daylight saving time rule: DST starts on the startWeek'th startDayOfWeek
+// (0 = Sunday; week 5 = the last one) of startMonth at startHour, and ends
+// likewise.  Switch hours are local standard time for the start and local
+// daylight time for the end, or GMT for both when utcSwitch is true.
+struct SiderealDSTRule {
+  byte startMonth, startWeek, startDayOfWeek;
+  byte endMonth, endWeek, endDayOfWeek;
+  float startHour, endHour;
+  boolean utcSwitch;
+  float amount; // hours added while DST is in effect
+};
+
+// United States since 2007, European Union, and south-east Australia
+constexpr SiderealDSTRule SP_DST_US = {3, 2, 0, 11, 1, 0, 2.0, 2.0, false, 1.0};
+constexpr SiderealDSTRule SP_DST_EU = {3, 5, 0, 10, 5, 0, 1.0, 1.0, true, 1.0};
+constexpr SiderealDSTRule SP_DST_AU = {10, 1, 0, 4, 1, 0, 2.0, 3.0, false, 1.0};
+constexpr SiderealDSTRule SP_DST_NONE = {0, 0, 0, 0, 0, 0, 0.0, 0.0, false, 0.0};
+
+// Site terms of the parallax correction, from calcSiteConstants().
+// rhoSinLat and rhoCosLat are the observer's geocentric position in Earth radii.
+struct SiderealSiteConstants {
+  double longitude;
+  double sinLat;
+  double cosLat;
+  double rhoSinLat;
+  double rhoCosLat;
+};
+
+// The Moon and its lighting at one epoch, from doSunMoon()
+struct SiderealMoonPhase {
+  double epoch;          // days since 1900 January 0.5 GMT
+  double rightAscension; // Moon, geocentric, hours
+  double declination;    // Moon, geocentric, degrees
+  double distance;       // Moon, from the Earth's center, AU
+  double sunLongitude;   // Sun's true geocentric ecliptic longitude, degrees
+  double illumination;   // illuminated fraction, 0 to 1
+  double phaseAngle;     // Sun-Moon-Earth angle, degrees: 0 full, 180 new
+  int phase;             // as getMoonPhase(), 0 (New Moon) to 7 (Waning Crescent)
+};
+
+// Progress of a resumable Sun or Moon rise/set search, from startRiseSet().
+// The caller keeps it, so a search costs no RAM in the SiderealPlanets object.
+struct SiderealRiseSetState {
+  double riseLST, setLST;         // latest guesses, local sidereal hours
+  double riseGMT, setGMT;         // the same as GMT hours
+  double lastRiseGMT, lastSetGMT; // the guesses before (Moon)
+  byte body;                      // SP_SUN or SP_MOON
+  byte step;                      // evaluations done
+  boolean done;                   // no more steps to run
+  boolean found;                  // as doSunRiseSetTimes() or doMoonRiseSetTimes() returns
+};
+
+// Progress of a resumable planet position, from startPlanet().  The caller
+// keeps it, like SiderealRiseSetState.
+struct SiderealPlanetState {
+  double sunMeanAnomaly, radiusVectorEarth, earthEclipticLongitude; // radians, AU
+  double lightTravelTime;           // days, from the last pass
+  double RD, LL, PD, sinPS, cosPS;  // projected radius, elongation and heliocentric terms of the last pass
+  byte planet;                      // 1 (Mercury) to 7 (Neptune)
+  byte step;                        // stages done
+  byte passes;                      // light time passes: 2, or 1 below SP_ACCURACY_FULL
+  boolean done;                     // no more stages to run
+};
+
 // Sidereal_Planets library description
 class SiderealPlanets {
   // user-accessible "public" interface
@@ -66,12 +204,22 @@ class SiderealPlanets {
 	boolean setTimeZone(int zone);
 	boolean setTimeZone(float zone);
     boolean useAutoDST(void);
+    boolean useAutoDST(const SiderealDSTRule &rule);
+    static boolean calcDSTtransitions(int year, float zone, const SiderealDSTRule &rule, double &start, double &end);
 	void setDST(void);
 	void rejectDST(void);
     boolean setLatLong(double latitude, double longitude);
 	boolean setGMTdate(int year, int month, int day);
     boolean setGMTtime(int hours, int minutes, float seconds);
     boolean setLocalTime(int hours, int minutes, float seconds);
+    boolean setGMTepoch(double epoch);
+    boolean setJulianDate(long day, double fraction);
+    boolean setMJD(long day, double fraction);
+    boolean setUnixTime(int64_t seconds, double fraction = 0.);
+    double getGMTepoch(void);
+    static boolean calcEpochsFromUnix(const int64_t *seconds, double *epochs, int count);
+    static boolean calcEpochsFromJD(const double *julianDates, double *epochs, int count);
+    static boolean calcEpochsFromMJD(const double *modifiedJulianDates, double *epochs, int count);
 	double getLatitude(void);
 	double getLongitude(void);
 	double getGMT(void);
@@ -99,27 +247,57 @@ class SiderealPlanets {
 	double getEclipticLongitude(void);
 	double getEclipticLatitude(void);
 	boolean doEcliptic2RAdec(void);
+#ifndef SIDEREAL_PLANETS_NO_PRECESSION
     boolean doPrecessFrom2000(void);
 	boolean doPrecessTo2000(void);
+#endif
 	boolean doLunarParallax(void);
+	boolean doTopocentric(const double *epochs, SiderealPosition *positions, int count);
+	static void calcSiteConstants(const SiderealSite &site, SiderealSiteConstants &constants);
+	static boolean doTopocentricSites(double epoch, const SiderealPosition &geocentric,
+	  const SiderealSiteConstants *sites, SiderealPosition *output, int count);
+	static double calcGMTsiderealTime(double epoch);
+	boolean doTrack(int body, const double *epochs, const double *latitudes, const double *longitudes,
+	  const double *elevations, int count, double *altitudes, double *azimuths, double window = 1. / 24.);
+	boolean doSkyGrid(double raStart, double raStep, int raCount, double decStart, double decStep, int decCount,
+	  float *altitudes, float *azimuths);
+	boolean doAltAz2RAdec(const float *altitudes, const float *azimuths, long count, float *rightAscensions,
+	  float *declinations);
+	boolean doVector2RAdec(const float *east, const float *north, const float *up, long count,
+	  float *rightAscensions, float *declinations);
+#ifndef SIDEREAL_PLANETS_NO_MOON
 	float getLunarLuminance(void);
 	int getMoonPhase(void);
+	boolean doSunMoon(SiderealMoonPhase &moon);
+	boolean doSunMoon(const double *epochs, SiderealMoonPhase *moons, int count);
+	boolean doMoonCalendar(int year, int month, SiderealMoonPhase *days, int &dayCount);
+#endif
 	boolean setEquatHorizontalParallax(double hp); //For testing only
 	double getEquatHorizontalParallax(void);
+#ifndef SIDEREAL_PLANETS_NO_REFRACTION
     boolean doRefractionF(double pressure, double temperature);
     boolean doRefractionC(double pressure, double temperature);
 	boolean doAntiRefractionF(double pressure, double temperature);
 	boolean doAntiRefractionC(double pressure, double temperature);
+	static double calcRefraction(double altitudeRad, double pressure, double temperature);
+#endif
+#ifndef SIDEREAL_PLANETS_NO_RISESET
 	boolean doRiseSetTimes(double DI);
 	double getRiseTime(void);
 	double getSetTime(void);
+#endif
 	double doAnomaly(double meanAnomaly, double eccentricity);
 	double getTrueAnomaly(void);
     boolean doSun(void);
+#ifndef SIDEREAL_PLANETS_NO_MOON
     boolean doMoon(void);
+#endif
+#ifndef SIDEREAL_PLANETS_NO_PLANETS
 	boolean doPlanetElements(void);
 	double getPL(int i, int j);
 	boolean doPlans(int IP);
+	boolean startPlanet(int planetNumber, SiderealPlanetState &state);
+	boolean doPlanetStep(SiderealPlanetState &state);
 	double getHelioLong(void);
 	double getHelioLat(void);
 	double getRadiusVec(void);
@@ -131,61 +309,121 @@ class SiderealPlanets {
     boolean doSaturn(void);
     boolean doUranus(void);
 	boolean doNeptune(void);
+#endif
+	double getEarthHelioLong(void);
+	double getEarthRadiusVec(void);
+	boolean doBody(int body);
+	double getBodyDistance(void);
+	boolean setAccuracy(int tier);
+	int getAccuracy(void);
+#ifndef SIDEREAL_PLANETS_NO_RISESET
 	boolean doSunRiseSetTimes(void);
+	boolean startRiseSet(int body, SiderealRiseSetState &state);
+	boolean doRiseSetStep(SiderealRiseSetState &state);
 	double getSunriseTime(void);
 	double getSunsetTime(void);
+#ifndef SIDEREAL_PLANETS_NO_MOON
 	boolean doMoonRiseSetTimes(void);
 	boolean getMoonRiseValidFlag(void);
 	double getMoonriseTime(void);
 	boolean getMoonSetValidFlag(void);
 	double getMoonsetTime(void);
+#endif
+#endif
 	void printDegMinSecs(double n);
 	
   // library-accessible "private" interface
   private:
-    const double F2PI = 2.0 * M_PI;
-    const double FPI  = M_PI;
-    const double FPIdiv2 = M_PI_2;
-    const double FminusPIdiv2 = -M_PI_2;
-    const double FPIdiv4 = M_PI_4;
-
-    float TimeZoneOffset;
-	int DSToffset;
-	double decLat, decLong, radLat, radLong, cosLat, sinLat, mjd1900;
-	boolean autoDST, useDST, leapYear, DstSelected, GmtDateInput, GmtTimeInput;
-	boolean MJDdone, precessArrayDone;
-	boolean obliquityDone, nutationDone, Ecl2RaDecDone, risetDone;
-	boolean doMoonDone; // Keep track if doMoon() has been called
-	boolean getLunarLuminanceDone; // Keep track if getLunarLuminance() has been called
-	boolean moonRiseValidFlag, moonSetValidFlag;
-	int GMTyear, GMTmonth, GMTday, GMTminute, GMThour;
-	float GMTseconds;
-	double julianCenturies1900, GMTtime, GMTsiderealTime, LocalSiderealTime;
-	double seaLevelHeightMeters, EquatHorizontalParallax;
+    // Constants and tables are shared by every instance and cost no RAM
+    static constexpr double F2PI = 2.0 * M_PI;
+    static constexpr double FPI  = M_PI;
+    static constexpr double FPIdiv2 = M_PI_2;
+    static constexpr double FminusPIdiv2 = -M_PI_2;
+    static constexpr double FPIdiv4 = M_PI_4;
+    static const byte monthDays[25]; // PROGMEM; days per month, leap year at +12
+
+    // Per-instance state, largest members first so there is no padding.
+    // The RegressionTests sketch prints sizeof(SiderealPlanets) to track it.
+    // Observer site, and its geocentric components for doLunarParallax()
+	double decLat, decLong, radLat, cosLat, sinLat, seaLevelHeightMeters;
+	double rhoSinLat, rhoCosLat;
+	// Time: mjd1900 is the day at 0h GMT, GMTtime the hours into that day
+	double mjd1900, julianCenturies1900, GMTtime;
+	// Current sky position, in degrees/hours, in radians, and its sin/cos
 	double RAdec, DeclinationDec, AltDec, AzDec;
 	double RArad, DeclinationRad, AltRad, AzRad;
 	double sinRA, sinDec, sinAlt, sinAz;
 	double cosRA, cosDec, cosAlt, cosAz;
-	double precessionMatrix[4][4], otherPrecessionMatrix[4][4]; //precession arrays
-    double trueAnomaly, eccentricAnomaly, meanAnomaly;
-	double nutationInLongitude, nutationInObliquity, obliquityEcliptic; //nutation, obliquity
-	double EclLongitude, EclLatitude, sineObliquity, cosineObliquity, SP_meanAnomaly, sunTrueGeocentricLongitude, sunEarthDistance, apparentEclipticLongitude;
+	double EclLongitude, EclLatitude;
+	// Cached per date: precession matrix to 2000.0 (its transpose goes back), nutation, obliquity
+#ifndef SIDEREAL_PLANETS_NO_PRECESSION
+	SiderealMatrix precessionMatrix;
+#endif
+	double nutationInLongitude, nutationInObliquity, obliquityEcliptic, sineObliquity, cosineObliquity;
+	// Results of doAnomaly(), doSun() and doMoon() that later calls reuse
+    double trueAnomaly, eccentricAnomaly, SP_meanAnomaly;
+	double sunTrueGeocentricLongitude, sunEarthDistance, EquatHorizontalParallax;
+#ifndef SIDEREAL_PLANETS_NO_MOON
 	double sunMeanAnomaly, moonMeanAnomaly, moonGeocentricEclipticLongitude, moonGeocentricEclipticLatitude;
-	float LunarIrradiance;
-	double azimuthRising, azimuthSetting, localSiderealTimeRising, localSiderealTimeSetting, heliocenttricEclipticLongitude, heliocenttricEclipticLatitude, radiusVectorPlanet, distanceEarthNotCorrected, moonHorizontalParallax;
-	double planetaryOrbitalElements[8][10]; //array for planetary elements
+	double moonHorizontalParallax;
+#endif
+#ifndef SIDEREAL_PLANETS_NO_RISESET
+	// Rise/set results
+	double azimuthRising, azimuthSetting, localSiderealTimeRising, localSiderealTimeSetting;
+#endif
+#ifndef SIDEREAL_PLANETS_NO_PLANETS
+	// Planet results and the date dependent orbital elements 1 to 6, stored
+	// as planetaryOrbitalElements[planet - 1][element - 1]
+	double heliocenttricEclipticLongitude, heliocenttricEclipticLatitude, radiusVectorPlanet, distanceEarthNotCorrected;
+	double planetaryOrbitalElements[7][6];
+#endif
+	SiderealDSTRule dstRule; // Rule used by useAutoDST(), copied so the caller's may go away
+	float TimeZoneOffset, GMTseconds, LunarIrradiance;
+	float DSToffset; // hours; the rule's amount while auto DST is in effect
+	int GMTyear;
+	byte GMTmonth, GMTday, GMThour, GMTminute;
+	byte lastBody; // Body computed by the last doBody() call
+	byte accuracy; // SP_ACCURACY_FULL to SP_ACCURACY_DEGREE
+	// Flags, one bit each
+	boolean autoDST : 1, useDST : 1, DstSelected : 1, GmtDateInput : 1, GmtTimeInput : 1;
+	boolean MJDdone : 1, precessArrayDone : 1;
+	boolean obliquityDone : 1, nutationDone : 1, Ecl2RaDecDone : 1, risetDone : 1;
+	boolean doMoonDone : 1; // Keep track if doMoon() has been called
+	boolean getLunarLuminanceDone : 1; // Keep track if getLunarLuminance() has been called
+	boolean moonRiseValidFlag : 1, moonSetValidFlag : 1;
 
     void doAutoDST(void);
-	byte calcLocalHour(int year, byte month, byte day, byte hour, byte offset);
-	char day_of_week(int year, int month, int day);
+	static char day_of_week(int year, int month, int day);
+	static double calcRuleDay(int year, byte month, byte week, byte dayOfWeek);
 	double inRange24(double d);
 	double inRange360(double d);
 	double inRange2PI(double d);
 	double deg2rad(double n);
 	double rad2deg(double n);
+#ifndef SIDEREAL_PLANETS_NO_PRECESSION
 	boolean doPrecessArray(void);
+#endif
+	boolean setGMTday(long day, double fraction);
+	void doSiteConstants(void);
+	void doSunLongitude(void);
+#ifndef SIDEREAL_PLANETS_NO_RISESET
+	boolean calcRiseSetAt(int body, double gmt, boolean shift);
+#endif
+#ifndef SIDEREAL_PLANETS_NO_MOON
+	double calcLunarIllumination(void);
+	int calcMoonPhase(void);
+#endif
+	void calcHorizon2Equator(double matrix[3][3]);
+	static void calcVector2RAdec(const double matrix[3][3], double east, double north, double up,
+	  float &rightAscension, float &declination);
+	static void calcTopocentric(double localSiderealTime, const SiderealSiteConstants &site,
+	  const SiderealPosition &geocentric, SiderealPosition &topocentric);
+#ifndef SIDEREAL_PLANETS_NO_PLANETS
+	double &PL(int i, int j) { return planetaryOrbitalElements[i - 1][j - 1]; }
+	void doPlanetPass(SiderealPlanetState &state, int pass);
+	void doPlanetPosition(const SiderealPlanetState &state);
+#endif
 
-    int monthDays[25] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
     union FourByte {
       unsigned long bit32;
       unsigned int bit16[2];
@@ -0,0 +1,118 @@
+/******************************************************************************
+SiderealRefraction.cpp
+Sidereal Planets refraction table C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses math.h for math functions
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealRefraction.h"
+
+#ifndef SIDEREAL_PLANETS_NO_REFRACTION
+
+// Public Methods //////////////////////////////////////////////////////////
+boolean SiderealRefraction::begin(void) {
+  tableDone = false;
+  return true;
+}
+
+// Pressure in millibars, temperature in Celsius, as for doRefractionC()
+boolean SiderealRefraction::setWeatherC(double pressure, double temperature) {
+  if (tableDone && tablePressure == pressure && tableTemperature == temperature) return true; //Already did it
+  if (temperature <= -273.) return false; //bad input
+  tablePressure = pressure;
+  tableTemperature = temperature;
+  for (int i = 0; i < TableSize; i++) {
+    refractionTable[i] = calcRefraction(tableAltitude(i));
+    antiRefractionTable[i] = calcAntiRefraction(tableAltitude(i));
+  }
+  tableDone = true;
+  return true;
+}
+
+// Pressure in inches of Mercury, temperature in Farenheit, as for doRefractionF()
+boolean SiderealRefraction::setWeatherF(double pressure, double temperature) {
+  pressure *= 33.8639;
+  temperature = (temperature - 32.) * (5. / 9.);
+  return setWeatherC(pressure, temperature);
+}
+
+// Correction in degrees that doRefractionC() adds to this altitude (degrees).
+// Without a table, compute it directly for the current weather.
+double SiderealRefraction::getRefraction(double altitude) {
+  if (!tableDone || altitude < -4.0) return calcRefraction(altitude);
+  return interpolate(refractionTable, altitude);
+}
+
+// Correction in degrees that doAntiRefractionC() adds to this altitude (degrees)
+double SiderealRefraction::getAntiRefraction(double altitude) {
+  if (!tableDone || altitude < -4.0) return calcAntiRefraction(altitude);
+  return interpolate(antiRefractionTable, altitude);
+}
+
+// Apply refraction to an array of altitudes in degrees.
+// The output array may be the same as the input array.
+boolean SiderealRefraction::doRefraction(const double *altitudes, double *output, int count) {
+  if (!tableDone || altitudes == NULL || output == NULL) return false;
+  for (int i = 0; i < count; i++) {
+    output[i] = altitudes[i] + getRefraction(altitudes[i]);
+  }
+  return true;
+}
+
+// Remove refraction from an array of altitudes in degrees.
+// The output array may be the same as the input array.
+boolean SiderealRefraction::doAntiRefraction(const double *altitudes, double *output, int count) {
+  if (!tableDone || altitudes == NULL || output == NULL) return false;
+  for (int i = 0; i < count; i++) {
+    output[i] = altitudes[i] + getAntiRefraction(altitudes[i]);
+  }
+  return true;
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+// Altitude in degrees of table entry i
+double SiderealRefraction::tableAltitude(int i) {
+  if (i <= FineSteps) return -4.0 + (0.1 * i);
+  return 20.0 + (i - FineSteps);
+}
+
+// Same fixed point iteration as doRefractionC(), in degrees
+double SiderealRefraction::calcRefraction(double altitude) {
+  double y = altitude * 1.745329252e-2;
+  double r1 = 0.0;
+  double r2 = r1;
+  do {
+    r1 = r2;
+    r2 = SiderealPlanets::calcRefraction(y + r1, tablePressure, tableTemperature);
+  } while (r2 != 0. && abs(r2 - r1) > 1e-6);
+  return r2 * 5.729577951e1;
+}
+
+// Same correction as doAntiRefractionC(), in degrees
+double SiderealRefraction::calcAntiRefraction(double altitude) {
+  return -SiderealPlanets::calcRefraction(altitude * 1.745329252e-2, tablePressure, tableTemperature) * 5.729577951e1;
+}
+
+double SiderealRefraction::interpolate(const float *table, double altitude) {
+  double x;
+  if (altitude < 20.0) {
+    x = (altitude + 4.0) * 10.0;
+  } else {
+    x = FineSteps + (altitude - 20.0);
+  }
+  int i = (int)x;
+  if (i >= TableSize - 1) return table[TableSize - 1];
+  double f = x - i;
+  return table[i] + f * (table[i + 1] - table[i]);
+}
+
+#endif // SIDEREAL_PLANETS_NO_REFRACTION
@@ -0,0 +1,60 @@
+/******************************************************************************
+SiderealRefraction.h
+Sidereal Planets refraction table Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealRefraction class, as implemented in SiderealRefraction.cpp
+
+doRefractionC() iterates the refraction formula on every call.  This class
+tabulates the same results over altitude once for a given pressure and
+temperature, and then corrects whole arrays of altitudes by interpolation.
+The tables are only rebuilt when the weather inputs change.
+
+Table layout: 0.1 degree steps from -4 to 20 degrees, where refraction changes
+quickly, then 1 degree steps up to 90 degrees.  Above the horizon the
+interpolation error stays below 1 arc second, apart from the 0.1 degree step
+where the formula itself switches branches at 15 degrees.  Between -4 and 0
+degrees it grows to a few arc seconds.  Below -4 degrees the formula is
+evaluated directly.  Two float tables of 311 entries use about 2.5K of RAM.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealRefraction_h
+#define __SiderealRefraction_h
+
+#include "SiderealPlanets.h"
+
+#ifndef SIDEREAL_PLANETS_NO_REFRACTION
+
+class SiderealRefraction {
+  public:
+    boolean begin(void);
+    boolean setWeatherC(double pressure, double temperature);
+    boolean setWeatherF(double pressure, double temperature);
+    double getRefraction(double altitude);
+    double getAntiRefraction(double altitude);
+    boolean doRefraction(const double *altitudes, double *output, int count);
+    boolean doAntiRefraction(const double *altitudes, double *output, int count);
+
+  private:
+    static constexpr int FineSteps = 240;    // -4 to 20 degrees by 0.1
+    static constexpr int CoarseSteps = 70;   // 20 to 90 degrees by 1
+    static constexpr int TableSize = FineSteps + CoarseSteps + 1;
+
+    double tablePressure = 1010., tableTemperature = 10.; // millibars, Celsius
+    boolean tableDone = false;
+    float refractionTable[TableSize];     // doRefractionC() correction, degrees
+    float antiRefractionTable[TableSize]; // doAntiRefractionC() correction, degrees
+
+    double tableAltitude(int i);
+    double calcRefraction(double altitude);
+    double calcAntiRefraction(double altitude);
+    double interpolate(const float *table, double altitude);
+};
+#endif // SIDEREAL_PLANETS_NO_REFRACTION
+#endif
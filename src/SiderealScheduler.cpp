@@ -0,0 +1,202 @@
+/******************************************************************************
+SiderealScheduler.cpp
+Sidereal Planets work-stealing parallel scheduler C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses the C++ standard library threads only (std::thread, std::mutex)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealScheduler.h"
+
+#ifdef SIDEREAL_PLANETS_THREADS
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+// Items [first, last) still owned by one worker. A cache line of padding
+// keeps neighbouring ranges off each other's lines, so the owner and a thief
+// do not fight over them. (alignas(64) would do the same, but plain new does
+// not honour it before C++17.)
+struct SiderealScheduler::WorkerRange {
+  std::mutex lock;
+  long first;
+  long last;
+  char padding[64];
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Public Methods //////////////////////////////////////////////////////////
+// Use all cores unless a worker count is given
+boolean SiderealScheduler::begin(int workers) {
+  if (workers < 0) return false; //bad input
+  if (workers == 0) workers = (int)std::thread::hardware_concurrency();
+  if (workers < 1) workers = 1;
+  workerCount = workers;
+  elapsedSeconds = 0.;
+  stats.assign(workerCount, SiderealWorkerStats());
+  if (!prototype) {
+    prototype.reset(new SiderealPlanets());
+    prototype->begin();
+  }
+  return true;
+}
+
+int SiderealScheduler::getWorkerCount(void) {
+  return workerCount;
+}
+
+// Every worker starts each run with a copy of this object, so time zone,
+// DST and site settings made on it carry over to the tasks.
+void SiderealScheduler::setPrototype(const SiderealPlanets &astro) {
+  prototype.reset(new SiderealPlanets(astro));
+}
+
+boolean SiderealScheduler::run(long itemCount, const SiderealWorkItem &task, long grainSize) {
+  if (workerCount < 1) return false; //begin() not called
+  if (itemCount < 0 || !task) return false;
+  stats.assign(workerCount, SiderealWorkerStats());
+  elapsedSeconds = 0.;
+  if (itemCount == 0) return true;
+  // Small chunks balance better, large chunks lock less. Aim for ~64 per worker.
+  if (grainSize < 1) grainSize = itemCount / ((long)workerCount * 64);
+  if (grainSize < 1) grainSize = 1;
+
+  // Deal out equal contiguous ranges; stealing evens out the uneven item cost
+  std::unique_ptr<WorkerRange[]> ranges(new WorkerRange[workerCount]);
+  for (int i = 0; i < workerCount; i++) {
+    ranges[i].first = (itemCount * i) / workerCount;
+    ranges[i].last = (itemCount * (i + 1)) / workerCount;
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 1; i < workerCount; i++) {
+    threads.push_back(std::thread(&SiderealScheduler::doWorker, this, i, ranges.get(), std::cref(task), grainSize));
+  }
+  doWorker(0, ranges.get(), task, grainSize); // The calling thread is worker 0
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  elapsedSeconds = secondsSince(start);
+  return true;
+}
+
+boolean SiderealScheduler::runGrid(const SiderealGrid &grid, SiderealPosition *output, long grainSize) {
+  if (output == NULL || grid.epochs == NULL || grid.sites == NULL || grid.bodies == NULL) return false;
+  if (grid.epochCount < 0 || grid.siteCount < 0 || grid.bodyCount < 0) return false;
+  long itemCount = grid.epochCount * grid.siteCount * grid.bodyCount;
+  // Epoch-major order: neighbouring items share a date, so each worker's
+  // setGMTdate() finds the date already set and keeps its cached MJD.
+  return run(itemCount, [&grid, output](SiderealPlanets &astro, long item, int) {
+    long b = item % grid.bodyCount;
+    long s = (item / grid.bodyCount) % grid.siteCount;
+    long e = item / (grid.bodyCount * grid.siteCount);
+    const SiderealEpoch &epoch = grid.epochs[e];
+    const SiderealSite &site = grid.sites[s];
+    SiderealPosition &out = output[item];
+    astro.setLatLong(site.latitude, site.longitude);
+    astro.setElevationM(site.elevation);
+    astro.setGMTdate(epoch.year, epoch.month, epoch.day);
+    astro.setGMTtime(epoch.hour, epoch.minute, epoch.seconds);
+    astro.doBody(grid.bodies[b]);
+    out.distance = astro.getBodyDistance();
+    if (grid.bodies[b] == SP_MOON) astro.doLunarParallax(); // as seen from the site
+    out.rightAscension = astro.getRAdec();
+    out.declination = astro.getDeclinationDec();
+    astro.doRAdec2AltAz();
+    out.altitude = astro.getAltitude();
+    out.azimuth = astro.getAzimuth();
+  }, grainSize);
+}
+
+const SiderealWorkerStats &SiderealScheduler::getWorkerStats(int worker) {
+  // All zeros before begin(), so callers never read past an empty table
+  static const SiderealWorkerStats none = {0, 0, 0, 0., 0.};
+  if (stats.empty()) return none;
+  if (worker < 0 || worker >= (int)stats.size()) worker = 0;
+  return stats[worker];
+}
+
+double SiderealScheduler::getElapsedSeconds(void) {
+  return elapsedSeconds;
+}
+
+void SiderealScheduler::printWorkerStats(void) {
+  long total = 0;
+  for (size_t i = 0; i < stats.size(); i++) {
+    printf("worker %2d: %9ld items %6ld chunks %4ld steals %9.4f s %12.1f items/s\n", (int)i,
+      stats[i].items, stats[i].chunks, stats[i].steals, stats[i].busySeconds, stats[i].itemsPerSecond);
+    total += stats[i].items;
+  }
+  if (elapsedSeconds > 0.)
+    printf("total: %ld items in %.4f s = %.1f items/s\n", total, elapsedSeconds, total / elapsedSeconds);
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+void SiderealScheduler::doWorker(int worker, WorkerRange *ranges, const SiderealWorkItem &task, long grainSize) {
+  SiderealPlanets astro(*prototype);
+  SiderealWorkerStats ws = SiderealWorkerStats(); // Local copy, no false sharing
+  long first, last;
+  std::chrono::steady_clock::time_point start;
+  while (true) {
+    while (takeChunk(ranges[worker], grainSize, first, last)) {
+      ws.chunks++;
+      start = std::chrono::steady_clock::now();
+      for (long item = first; item < last; item++) {
+        task(astro, item, worker);
+      }
+      ws.busySeconds += secondsSince(start);
+      ws.items += last - first;
+    }
+    if (stealChunk(worker, ranges) == false) break; //all work done
+    ws.steals++;
+  }
+  if (ws.busySeconds > 0.) ws.itemsPerSecond = ws.items / ws.busySeconds;
+  stats[worker] = ws;
+}
+
+// Owner side: take one grain from the front of our own range
+boolean SiderealScheduler::takeChunk(WorkerRange &range, long grainSize, long &first, long &last) {
+  std::lock_guard<std::mutex> guard(range.lock);
+  if (range.first >= range.last) return false;
+  first = range.first;
+  last = first + grainSize;
+  if (last > range.last) last = range.last;
+  range.first = last;
+  return true;
+}
+
+// Thief side: move the back half of the first busy victim's range into ours.
+// Returns false once every other range is empty.
+boolean SiderealScheduler::stealChunk(int thief, WorkerRange *ranges) {
+  long first = 0, last = 0;
+  for (int k = 1; k < workerCount; k++) {
+    WorkerRange &victim = ranges[(thief + k) % workerCount];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    long remaining = victim.last - victim.first;
+    if (remaining <= 0) continue;
+    first = victim.first + remaining / 2;
+    last = victim.last;
+    victim.last = first;
+    break;
+  }
+  if (first >= last) return false;
+  std::lock_guard<std::mutex> guard(ranges[thief].lock);
+  ranges[thief].first = first;
+  ranges[thief].last = last;
+  return true;
+}
+
+#endif // SIDEREAL_PLANETS_THREADS
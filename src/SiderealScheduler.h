@@ -0,0 +1,85 @@
+/******************************************************************************
+SiderealScheduler.h
+Sidereal Planets work-stealing parallel scheduler Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealScheduler class, as implemented in SiderealScheduler.cpp
+
+Grid jobs (every epoch, every site, every body) are split into chunks of items
+and run on all cores.  Each worker owns a range of items and takes chunks from
+its front; an idle worker steals the back half of another worker's range.  That
+keeps the cores busy even though a doPlans(4) item costs many times more than a
+doSun() item.
+
+Resources:
+Uses the C++ standard library threads only (std::thread, std::mutex)
+Only built when SIDEREAL_PLANETS_THREADS is defined (the default on the host)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealScheduler_h
+#define __SiderealScheduler_h
+
+#include "SiderealPlanets.h"
+
+#ifdef SIDEREAL_PLANETS_THREADS
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// A grid of (epoch x site x body) items. Output item index is
+// ((epoch * siteCount) + site) * bodyCount + body
+struct SiderealGrid {
+  const SiderealEpoch *epochs;
+  long epochCount;
+  const SiderealSite *sites;
+  long siteCount;
+  const int *bodies; // SiderealBody numbers
+  long bodyCount;
+};
+
+// Throughput report for one worker of the last run
+struct SiderealWorkerStats {
+  long items;            // items processed
+  long chunks;           // chunks taken, own or stolen
+  long steals;           // successful steals from other workers
+  double busySeconds;    // time spent inside the task
+  double itemsPerSecond; // items / busySeconds
+};
+
+// Task for one item. Every worker owns a private copy of the prototype
+// SiderealPlanets object, so tasks never share mutable state.
+typedef std::function<void(SiderealPlanets &astro, long item, int worker)> SiderealWorkItem;
+
+class SiderealScheduler {
+  public:
+    boolean begin(int workers = 0);
+    int getWorkerCount(void);
+    void setPrototype(const SiderealPlanets &astro);
+    boolean run(long itemCount, const SiderealWorkItem &task, long grainSize = 0);
+    boolean runGrid(const SiderealGrid &grid, SiderealPosition *output, long grainSize = 0);
+    const SiderealWorkerStats &getWorkerStats(int worker);
+    double getElapsedSeconds(void);
+    void printWorkerStats(void);
+
+  private:
+    struct WorkerRange; // Defined in SiderealScheduler.cpp
+
+    int workerCount = 0;
+    double elapsedSeconds = 0.;
+    std::unique_ptr<SiderealPlanets> prototype;
+    std::vector<SiderealWorkerStats> stats;
+
+    void doWorker(int worker, WorkerRange *ranges, const SiderealWorkItem &task, long grainSize);
+    boolean takeChunk(WorkerRange &range, long grainSize, long &first, long &last);
+    boolean stealChunk(int thief, WorkerRange *ranges);
+};
+
+#endif // SIDEREAL_PLANETS_THREADS
+#endif
@@ -0,0 +1,84 @@
+/******************************************************************************
+SiderealSkyState.cpp
+Sidereal Planets lock-free sky state publisher C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses the C++ standard library atomics only (std::atomic)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealSkyState.h"
+
+#ifdef SIDEREAL_PLANETS_THREADS
+
+#include <string.h>
+#include <thread>
+
+// Public Methods //////////////////////////////////////////////////////////
+// Publish a state; its version is set here.  Call from one thread only.
+boolean SiderealSkyPublisher::setState(const SiderealSkyState &state) {
+  unsigned long s = sequence.load(std::memory_order_relaxed);
+  SiderealSkyState record = state;
+  record.version = (s / 2) + 1;
+  uint64_t copy[Words] = {};
+  memcpy(copy, &record, sizeof(SiderealSkyState));
+  sequence.store(s + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (int i = 0; i < Words; i++) words[i].store(copy[i], std::memory_order_relaxed);
+  sequence.store(s + 2, std::memory_order_release);
+  return true;
+}
+
+// Publish the time and position now held by astro, after doBody() (pass the
+// body, to include its distance) or setRAdec(), and doRAdec2AltAz()
+boolean SiderealSkyPublisher::setState(SiderealPlanets &astro, int body) {
+  SiderealSkyState state;
+  state.epoch = astro.getGMTepoch();
+  state.localSiderealTime = astro.getLocalSiderealTime();
+  state.position.rightAscension = astro.getRAdec();
+  state.position.declination = astro.getDeclinationDec();
+  state.position.altitude = astro.getAltitude();
+  state.position.azimuth = astro.getAzimuth();
+  state.position.distance = (body >= 0) ? astro.getBodyDistance() : 0.;
+  state.body = body;
+  state.version = 0;
+  return setState(state);
+}
+
+// The latest state, whole.  Returns false if nothing has been published yet.
+boolean SiderealSkyPublisher::getState(SiderealSkyState &state) {
+  uint64_t copy[Words];
+  for (;;) {
+    unsigned long s = sequence.load(std::memory_order_acquire);
+    if (s == 0) return false; //nothing published yet
+    if ((s & 1) == 0) {
+      for (int i = 0; i < Words; i++) copy[i] = words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) == s) break;
+    } else {
+      std::this_thread::yield(); // the writer may have been switched out mid-store
+    }
+    retries.fetch_add(1, std::memory_order_relaxed); // the writer was storing; copy again
+  }
+  memcpy(&state, copy, sizeof(SiderealSkyState));
+  return true;
+}
+
+// Number of states published so far
+unsigned long SiderealSkyPublisher::getVersion(void) {
+  return sequence.load(std::memory_order_acquire) / 2;
+}
+
+// Number of times a reader had to copy again because the writer was storing
+long SiderealSkyPublisher::getRetries(void) {
+  return retries.load(std::memory_order_relaxed);
+}
+
+#endif // SIDEREAL_PLANETS_THREADS
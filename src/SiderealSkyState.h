@@ -0,0 +1,66 @@
+/******************************************************************************
+SiderealSkyState.h
+Sidereal Planets lock-free sky state publisher Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealSkyPublisher class, as implemented in SiderealSkyState.cpp
+
+Hands the latest computed position from one compute thread to any number of
+reader threads (display, logging, mount control) without locks.  A
+SiderealPlanets object overwrites its members one at a time while it works,
+so other threads must not read it directly.  Instead the compute thread fills
+a complete SiderealSkyState record and publishes it.  Readers always get a
+whole record, never half of one state and half of the next.
+
+Publishing is a sequence lock: the writer makes the sequence number odd,
+stores the record, then makes it even again.  A reader copies the record and
+checks that the sequence number was even and did not change; if it did, the
+reader copies again.  The writer never waits for readers, and readers never
+wait for each other.  Only one thread may publish to a given publisher.
+
+Resources:
+Uses the C++ standard library atomics only (std::atomic)
+Only built when SIDEREAL_PLANETS_THREADS is defined (the default on the host)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealSkyState_h
+#define __SiderealSkyState_h
+
+#include "SiderealPlanets.h"
+
+#ifdef SIDEREAL_PLANETS_THREADS
+
+#include <atomic>
+
+// One complete sky state, as published
+struct SiderealSkyState {
+  double epoch;                // days since 1900 January 0.5 GMT
+  double localSiderealTime;    // hours
+  SiderealPosition position;   // RA in hours, angles in degrees, distance in AU
+  int body;                    // as doBody(), or -1 for a position set with setRAdec()
+  unsigned long version;       // 1 for the first state published, and so on
+};
+
+class SiderealSkyPublisher {
+  public:
+    boolean setState(const SiderealSkyState &state);
+    boolean setState(SiderealPlanets &astro, int body = -1);
+    boolean getState(SiderealSkyState &state);
+    unsigned long getVersion(void);
+    long getRetries(void);
+
+  private:
+    static const int Words = (sizeof(SiderealSkyState) + 7) / 8;
+    std::atomic<unsigned long> sequence{0}; // odd while a state is being stored
+    std::atomic<uint64_t> words[Words] = {};
+    std::atomic<long> retries{0};
+};
+
+#endif // SIDEREAL_PLANETS_THREADS
+#endif
@@ -0,0 +1,163 @@
+/******************************************************************************
+SiderealSolarField.cpp
+Sidereal Planets heliostat field C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses math.h for math functions
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealSolarField.h"
+
+#ifndef SIDEREAL_PLANETS_NO_REFRACTION
+
+#ifdef SIDEREAL_PLANETS_HOST
+#include <chrono>
+#endif
+
+// Public Methods //////////////////////////////////////////////////////////
+// Field origin: latitude and longitude in degrees, elevation in meters
+boolean SiderealSolarField::begin(double latitude, double longitude, double elevation) {
+  if (latitude < -90. || latitude > 90.) return false; //bad input
+  astro.begin();
+  astro.setLatLong(latitude, longitude);
+  astro.setElevationM(elevation);
+  heliostatCount = 0;
+  targetEast = targetNorth = targetUp = NULL;
+  tickSeconds = maxTickSeconds = 0.;
+  return true;
+}
+
+// Pressure in millibars, temperature in Celsius, as for doRefractionC()
+boolean SiderealSolarField::setWeatherC(double pressure, double temperature) {
+  if (temperature <= -273.) return false; //bad input
+  this->pressure = pressure;
+  this->temperature = temperature;
+  return true;
+}
+
+// Heliostat pivot positions in meters.  The arrays are used in place, so
+// they must stay valid while the field is in use.
+boolean SiderealSolarField::setHeliostats(const double *east, const double *north, const double *up, int count) {
+  if (count < 0 || (count > 0 && (east == NULL || north == NULL || up == NULL))) return false; //bad input
+  heliostatEast = east;
+  heliostatNorth = north;
+  heliostatUp = up;
+  heliostatCount = count;
+  return true;
+}
+
+// One receiver aim point, in meters, for every heliostat
+boolean SiderealSolarField::setTarget(double east, double north, double up) {
+  fixedTarget[0] = east;
+  fixedTarget[1] = north;
+  fixedTarget[2] = up;
+  targetEast = targetNorth = targetUp = NULL;
+  return true;
+}
+
+// An aim point for each heliostat, in meters, in arrays as long as the
+// heliostat arrays
+boolean SiderealSolarField::setTargets(const double *east, const double *north, const double *up) {
+  if (east == NULL || north == NULL || up == NULL) return false; //bad input
+  targetEast = east;
+  targetNorth = north;
+  targetUp = up;
+  return true;
+}
+
+// Mirror normals (unit vectors, East, North, Up) of every heliostat at the
+// epoch (days since 1900 January 0.5 GMT).  If cosine is not NULL it gets the
+// cosine of the angle of incidence, the fraction of sunlight each mirror
+// intercepts.  The Sun may be below the horizon; check getSunAltitude().
+boolean SiderealSolarField::doTick(double epoch, double *normalEast, double *normalNorth, double *normalUp, double *cosine) {
+  if (heliostatCount > 0 && (normalEast == NULL || normalNorth == NULL || normalUp == NULL)) return false; //bad input
+#ifdef SIDEREAL_PLANETS_HOST
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#else
+  unsigned long start = micros();
+#endif
+  // The Sun, once for the whole field, seen from the origin (its parallax
+  // is up to 9 arc seconds) and then refracted
+  if (astro.setGMTepoch(epoch) == false) return false;
+  astro.doBody(SP_SUN);
+  SiderealPosition sunPosition = {astro.getRAdec(), astro.getDeclinationDec(), 0., 0., astro.getBodyDistance()};
+  astro.doTopocentric(&epoch, &sunPosition, 1);
+  astro.setRAdec(sunPosition.rightAscension, sunPosition.declination);
+  astro.doRAdec2AltAz();
+  astro.doRefractionC(pressure, temperature);
+  sunAltitude = astro.getAltitude();
+  sunAzimuth = astro.getAzimuth();
+  double alt = sunAltitude * 1.745329252e-2;
+  double az = sunAzimuth * 1.745329252e-2;
+  double sx = cos(alt) * sin(az);
+  double sy = cos(alt) * cos(az);
+  double sz = sin(alt);
+  sun[0] = sx;
+  sun[1] = sy;
+  sun[2] = sz;
+
+  // Then each heliostat: the bisector of the Sun and target directions
+  double tx = fixedTarget[0], ty = fixedTarget[1], tz = fixedTarget[2];
+  for (int i = 0; i < heliostatCount; i++) {
+    if (targetEast != NULL) {
+      tx = targetEast[i];
+      ty = targetNorth[i];
+      tz = targetUp[i];
+    }
+    double dx = tx - heliostatEast[i];
+    double dy = ty - heliostatNorth[i];
+    double dz = tz - heliostatUp[i];
+    double d = sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    if (d > 0.) d = 1. / d;
+    double nx = sx + (dx * d);
+    double ny = sy + (dy * d);
+    double nz = sz + (dz * d);
+    double n = sqrt((nx * nx) + (ny * ny) + (nz * nz));
+    if (n > 0.) n = 1. / n; // Zero only when the target is straight at the Sun
+    normalEast[i] = nx * n;
+    normalNorth[i] = ny * n;
+    normalUp[i] = nz * n;
+    if (cosine != NULL) cosine[i] = ((sx * nx) + (sy * ny) + (sz * nz)) * n;
+  }
+#ifdef SIDEREAL_PLANETS_HOST
+  tickSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+#else
+  tickSeconds = (micros() - start) * 1e-6;
+#endif
+  if (tickSeconds > maxTickSeconds) maxTickSeconds = tickSeconds;
+  return true;
+}
+
+// Apparent (refracted) altitude and azimuth of the Sun at the last tick, degrees
+double SiderealSolarField::getSunAltitude(void) {
+  return sunAltitude;
+}
+
+double SiderealSolarField::getSunAzimuth(void) {
+  return sunAzimuth;
+}
+
+void SiderealSolarField::getSunVector(double &east, double &north, double &up) {
+  east = sun[0];
+  north = sun[1];
+  up = sun[2];
+}
+
+// Time the last doTick() took, and the longest since begin()
+double SiderealSolarField::getTickSeconds(void) {
+  return tickSeconds;
+}
+
+double SiderealSolarField::getMaxTickSeconds(void) {
+  return maxTickSeconds;
+}
+
+#endif // SIDEREAL_PLANETS_NO_REFRACTION
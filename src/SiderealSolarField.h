@@ -0,0 +1,64 @@
+/******************************************************************************
+SiderealSolarField.h
+Sidereal Planets heliostat field Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealSolarField class, as implemented in SiderealSolarField.cpp
+
+A heliostat reflects the Sun onto a fixed target, so its mirror normal is the
+bisector of the unit vectors toward the Sun and toward the target.  Over a
+field a few kilometers across the Sun's direction is the same everywhere to
+well under an arc second, so each tick computes it once at the field origin
+(doSun(), doTopocentric(), doRAdec2AltAz(), doRefractionC()) and then runs one
+tight loop over all heliostats.
+
+Positions are in meters in the field's East, North, Up frame, passed as
+separate arrays (structure of arrays) that the caller keeps.  Nothing is
+copied or allocated, so the class also fits on a microcontroller.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealSolarField_h
+#define __SiderealSolarField_h
+
+#include "SiderealPlanets.h"
+
+#ifndef SIDEREAL_PLANETS_NO_REFRACTION
+
+class SiderealSolarField {
+  public:
+    boolean begin(double latitude, double longitude, double elevation);
+    boolean setWeatherC(double pressure, double temperature);
+    boolean setHeliostats(const double *east, const double *north, const double *up, int count);
+    boolean setTarget(double east, double north, double up);
+    boolean setTargets(const double *east, const double *north, const double *up);
+    boolean doTick(double epoch, double *normalEast, double *normalNorth, double *normalUp, double *cosine = NULL);
+    double getSunAltitude(void);
+    double getSunAzimuth(void);
+    void getSunVector(double &east, double &north, double &up);
+    double getTickSeconds(void);
+    double getMaxTickSeconds(void);
+
+  private:
+    SiderealPlanets astro;
+    double pressure = 1010.;   // millibars
+    double temperature = 10.;  // Celsius
+    const double *heliostatEast = NULL;
+    const double *heliostatNorth = NULL;
+    const double *heliostatUp = NULL;
+    int heliostatCount = 0;
+    const double *targetEast = NULL; // NULL: one target for all heliostats
+    const double *targetNorth = NULL;
+    const double *targetUp = NULL;
+    double fixedTarget[3] = {0., 0., 0.};
+    double sun[3] = {0., 0., 1.};      // unit vector, East, North, Up
+    double sunAltitude = 90., sunAzimuth = 0.;
+    double tickSeconds = 0., maxTickSeconds = 0.;
+};
+#endif // SIDEREAL_PLANETS_NO_REFRACTION
+#endif
@@ -0,0 +1,168 @@
+/******************************************************************************
+SiderealTask.cpp
+Sidereal Planets time-sliced computation C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses micros() for the slice budget (std::chrono on the host)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealTask.h"
+
+#ifdef SIDEREAL_PLANETS_HOST
+#include <chrono>
+#endif
+
+static const byte TaskPositions = 1;
+static const byte TaskRiseSet = 2;
+
+// Public Methods //////////////////////////////////////////////////////////
+// Tasks run on astro, with its date, time and site as set by the caller
+boolean SiderealTask::begin(SiderealPlanets &astro) {
+  this->astro = &astro;
+  task = 0;
+  done = true;
+  found = false;
+  longestStep = 0;
+  sliceSteps = 0;
+  sliceSeconds = maxSliceSeconds = 0.;
+  return true;
+}
+
+// RA/Dec, distance and altitude/azimuth of each body (SP_SUN to SP_MOON), as
+// doBody() and doRAdec2AltAz() give them.  The Moon's position is corrected
+// for parallax with doLunarParallax().  The arrays are used in place, so they
+// must stay valid until the task is done.
+boolean SiderealTask::startPositions(const int *bodies, int count, SiderealPosition *positions) {
+  if (astro == NULL) return false; //begin() not called
+  if (count < 0 || (count > 0 && (bodies == NULL || positions == NULL))) return false; //bad input
+  for (int i = 0; i < count; i++) {
+    if (bodies[i] < SP_SUN || bodies[i] > SP_MOON) return false; //bad body value
+  }
+  this->bodies = bodies;
+  this->positions = positions;
+  bodyCount = count;
+  nextBody = 0;
+#ifndef SIDEREAL_PLANETS_NO_PLANETS
+  planetStarted = false;
+#endif
+  task = TaskPositions;
+  done = (count == 0);
+  found = true;
+  return true;
+}
+
+#ifndef SIDEREAL_PLANETS_NO_RISESET
+// Rise and set times of SP_SUN or SP_MOON, as doSunRiseSetTimes() or
+// doMoonRiseSetTimes() finds them
+boolean SiderealTask::startRiseSet(int body) {
+  if (astro == NULL) return false; //begin() not called
+  if (astro->startRiseSet(body, riseSet) == false) return false; //bad body value
+  task = TaskRiseSet;
+  done = false;
+  found = false;
+  return true;
+}
+#endif
+
+// Run steps for up to budgetMicros microseconds, and at least one step.
+// A step is a doSun() or doMoon() call, one stage of a planet, or a rise/set
+// evaluation, so a budget below one step is overrun.  Returns true when the task is done.
+boolean SiderealTask::doSlice(unsigned long budgetMicros) {
+  unsigned long start = readMicros();
+  sliceSteps = 0;
+  while (!done) {
+    unsigned long before = readMicros();
+    doStep();
+    sliceSteps++;
+    unsigned long now = readMicros();
+    if (now - before > longestStep) longestStep = now - before;
+    if ((now - start) + longestStep > budgetMicros) break; // the next step might not fit
+  }
+  sliceSeconds = (readMicros() - start) * 1e-6;
+  if (sliceSeconds > maxSliceSeconds) maxSliceSeconds = sliceSeconds;
+  return done;
+}
+
+boolean SiderealTask::getDone(void) {
+  return done;
+}
+
+// Once done: false if a body could not be computed, or for rise/set, if the
+// body does not rise or set that day (as the blocking calls return)
+boolean SiderealTask::getFound(void) {
+  return found;
+}
+
+// Steps the last slice ran, the time it took, and the longest since begin()
+int SiderealTask::getSliceSteps(void) {
+  return sliceSteps;
+}
+
+double SiderealTask::getSliceSeconds(void) {
+  return sliceSeconds;
+}
+
+double SiderealTask::getMaxSliceSeconds(void) {
+  return maxSliceSeconds;
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+void SiderealTask::doStep(void) {
+#ifndef SIDEREAL_PLANETS_NO_RISESET
+  if (task == TaskRiseSet) {
+    astro->doRiseSetStep(riseSet);
+    done = riseSet.done;
+    found = riseSet.found;
+    return;
+  }
+#endif
+  int body = bodies[nextBody];
+  SiderealPosition &position = positions[nextBody];
+#ifndef SIDEREAL_PLANETS_NO_PLANETS
+  if (body >= SP_MERCURY && body <= SP_NEPTUNE) {
+    // A stage per step: the Sun and elements, each light time pass, and
+    // the apparent position
+    if (planetStarted == false) {
+      astro->startPlanet(body, planet);
+      planetStarted = true;
+    }
+    astro->doPlanetStep(planet);
+    if (planet.done == false) return;
+    planetStarted = false;
+    position.distance = astro->getDistance();
+  } else
+#endif
+  {
+    if (astro->doBody(body) == false) {
+      found = false; // left out of the build
+      done = true;
+      return;
+    }
+    position.distance = astro->getBodyDistance();
+  }
+  if (body == SP_MOON) astro->doLunarParallax();
+  position.rightAscension = astro->getRAdec();
+  position.declination = astro->getDeclinationDec();
+  astro->doRAdec2AltAz();
+  position.altitude = astro->getAltitude();
+  position.azimuth = astro->getAzimuth();
+  nextBody++;
+  done = (nextBody >= bodyCount);
+}
+
+unsigned long SiderealTask::readMicros(void) {
+#ifdef SIDEREAL_PLANETS_HOST
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return micros();
+#endif
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+SiderealTask.h
+Sidereal Planets time-sliced computation Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealTask class, as implemented in SiderealTask.cpp
+
+Runs the long computations a little at a time from loop(), so they can share
+a slow board with stepper, serial and other time-critical code.  A task is
+started, then each doSlice() call runs steps for up to the given number of
+microseconds and returns, reporting when the task is finished.
+
+A step is one evaluation: the Sun or Moon of a position update, one stage
+of a planet (see doPlanetStep(): the Sun and elements, each light time pass,
+and the apparent position), or one doSun() or doMoon() call of a rise/set
+search.  The longest step seen so far is taken as the cost of the next one,
+so a slice only starts a step that should still fit in its budget.  Each
+slice runs at least one step, so no slice is shorter than the slowest single
+evaluation (doMoon(); setAccuracy() makes it faster).
+
+Results are the same as the blocking calls give: positions go to the
+caller's array, and rise/set times are read from the SiderealPlanets object
+with getSunriseTime(), getMoonriseTime() and so on.  The date, time and site
+of that object must not change while a task runs.
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealTask_h
+#define __SiderealTask_h
+
+#include "SiderealPlanets.h"
+
+class SiderealTask {
+  public:
+    boolean begin(SiderealPlanets &astro);
+    boolean startPositions(const int *bodies, int count, SiderealPosition *positions);
+#ifndef SIDEREAL_PLANETS_NO_RISESET
+    boolean startRiseSet(int body);
+#endif
+    boolean doSlice(unsigned long budgetMicros);
+    boolean getDone(void);
+    boolean getFound(void);
+    int getSliceSteps(void);
+    double getSliceSeconds(void);
+    double getMaxSliceSeconds(void);
+
+  private:
+    SiderealPlanets *astro = NULL;
+    byte task = 0;              // what is running, or 0 for nothing
+    boolean done = true;
+    boolean found = false;
+    const int *bodies = NULL;   // position update
+    SiderealPosition *positions = NULL;
+    int bodyCount = 0;
+    int nextBody = 0;
+#ifndef SIDEREAL_PLANETS_NO_PLANETS
+    SiderealPlanetState planet;  // the planet part way through
+    boolean planetStarted = false;
+#endif
+#ifndef SIDEREAL_PLANETS_NO_RISESET
+    SiderealRiseSetState riseSet;
+#endif
+    unsigned long longestStep = 0; // microseconds
+    int sliceSteps = 0;
+    double sliceSeconds = 0., maxSliceSeconds = 0.;
+
+    void doStep(void);
+    static unsigned long readMicros(void);
+};
+#endif
@@ -0,0 +1,123 @@
+/******************************************************************************
+SiderealTimeZone.cpp
+Sidereal Planets time zone and DST table C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses the C++ standard library (std::vector, std::upper_bound)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealTimeZone.h"
+
+#ifdef SIDEREAL_PLANETS_HOST
+
+#include <algorithm>
+
+// Public Methods //////////////////////////////////////////////////////////
+// Build the table of DST transitions for firstYear to lastYear
+boolean SiderealTimeZone::begin(float zone, const SiderealDSTRule &rule, int firstYear, int lastYear) {
+  if (zone < -12.0 || zone > 14.0) return false; //bad input
+  if (firstYear > lastYear) return false;
+  zoneHours = zone;
+  dstRule = rule;
+  gmtSwitch.clear();
+  localSwitch.clear();
+  dstAfter.clear();
+  SiderealPlanets astro{};
+  astro.begin();
+  astro.setGMTdate(firstYear, 1, 1);
+  tableStart = astro.modifiedJulianDate1900();
+  astro.setGMTdate(lastYear + 1, 1, 1);
+  tableEnd = astro.modifiedJulianDate1900();
+  double start, end;
+  for (int year = firstYear; year <= lastYear; year++) {
+    if (SiderealPlanets::calcDSTtransitions(year, zone, rule, start, end) == false) break; //no DST
+    // Southern hemisphere years end DST before they start it
+    if (start < end) {
+      gmtSwitch.push_back(start); dstAfter.push_back(true);
+      gmtSwitch.push_back(end); dstAfter.push_back(false);
+    } else {
+      gmtSwitch.push_back(end); dstAfter.push_back(false);
+      gmtSwitch.push_back(start); dstAfter.push_back(true);
+    }
+  }
+  dstBefore = (!dstAfter.empty() && !dstAfter[0]);
+  for (size_t k = 0; k < gmtSwitch.size(); k++) {
+    double before = zoneHours + (dstAfter[k] ? 0. : dstRule.amount);
+    localSwitch.push_back(gmtSwitch[k] + (before / 24.0));
+  }
+  return true;
+}
+
+boolean SiderealTimeZone::isDST(double gmtEpoch) {
+  return calcDST(gmtEpoch, false);
+}
+
+// Hours to add to GMT to get local time
+double SiderealTimeZone::getOffset(double gmtEpoch) {
+  return zoneHours + (calcDST(gmtEpoch, false) ? dstRule.amount : 0.);
+}
+
+// Hours to subtract from local time to get GMT
+double SiderealTimeZone::getLocalOffset(double localEpoch) {
+  return zoneHours + (calcDST(localEpoch, true) ? dstRule.amount : 0.);
+}
+
+// The output array may be the same as the input array
+boolean SiderealTimeZone::doGMT2Local(const double *gmtEpochs, double *localEpochs, int count) {
+  if (gmtEpochs == NULL || localEpochs == NULL) return false;
+  for (int i = 0; i < count; i++) {
+    localEpochs[i] = gmtEpochs[i] + (getOffset(gmtEpochs[i]) / 24.0);
+  }
+  return true;
+}
+
+boolean SiderealTimeZone::doLocal2GMT(const double *localEpochs, double *gmtEpochs, int count) {
+  if (localEpochs == NULL || gmtEpochs == NULL) return false;
+  for (int i = 0; i < count; i++) {
+    gmtEpochs[i] = localEpochs[i] - (getLocalOffset(localEpochs[i]) / 24.0);
+  }
+  return true;
+}
+
+int SiderealTimeZone::getTransitionCount(void) {
+  return (int)gmtSwitch.size();
+}
+
+// GMT epoch of transition k; isDST() just after it tells which way it goes
+double SiderealTimeZone::getTransition(int k) {
+  if (k < 0 || k >= (int)gmtSwitch.size()) return 0.;
+  return gmtSwitch[k];
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+// Is DST in effect at this GMT (or local clock) epoch?
+boolean SiderealTimeZone::calcDST(double epoch, boolean local) {
+  if (gmtSwitch.empty()) return false;
+  double gmt = local ? epoch - (zoneHours / 24.0) : epoch;
+  if (gmt >= tableStart && gmt < tableEnd) {
+    const std::vector<double> &table = local ? localSwitch : gmtSwitch;
+    size_t k = std::upper_bound(table.begin(), table.end(), epoch) - table.begin();
+    return (k == 0) ? dstBefore : (dstAfter[k - 1] != 0);
+  }
+  // Outside the table, work out the transitions of that year directly.
+  // No rule switches near January 1, so an approximate year is enough.
+  int year = (int)floor(1900.0 + (gmt / 365.2425));
+  double start, end;
+  if (SiderealPlanets::calcDSTtransitions(year, zoneHours, dstRule, start, end) == false) return false;
+  if (local) {
+    start += zoneHours / 24.0;
+    end += (zoneHours + dstRule.amount) / 24.0;
+  }
+  if (start < end) return (epoch >= start && epoch < end);
+  return (epoch >= start || epoch < end);
+}
+
+#endif // SIDEREAL_PLANETS_HOST
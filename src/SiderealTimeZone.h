@@ -0,0 +1,64 @@
+/******************************************************************************
+SiderealTimeZone.h
+Sidereal Planets time zone and DST table Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealTimeZone class, as implemented in SiderealTimeZone.cpp
+
+Converts large numbers of timestamps between GMT and local time.  The DST
+start and end instants of every year in a range are worked out once with
+calcDSTtransitions(), and each conversion is then a binary search in that
+table.  Any SiderealDSTRule can be used (SP_DST_US, SP_DST_EU, SP_DST_AU,
+SP_DST_NONE, or your own), and the DST amount need not be a whole hour.
+
+Times are epochs in days since 1900 January 0.5 (see setGMTepoch()).  A
+local time in the hour skipped when DST starts is read as daylight time,
+and a local time in the hour repeated when DST ends as its first occurrence.
+Times outside the table years are still converted correctly, just without
+the table.
+
+Resources:
+Uses the C++ standard library (std::vector, std::upper_bound)
+Only built on the host (SIDEREAL_PLANETS_HOST)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealTimeZone_h
+#define __SiderealTimeZone_h
+
+#include "SiderealPlanets.h"
+
+#ifdef SIDEREAL_PLANETS_HOST
+
+#include <vector>
+
+class SiderealTimeZone {
+  public:
+    boolean begin(float zone, const SiderealDSTRule &rule, int firstYear, int lastYear);
+    boolean isDST(double gmtEpoch);
+    double getOffset(double gmtEpoch);
+    double getLocalOffset(double localEpoch);
+    boolean doGMT2Local(const double *gmtEpochs, double *localEpochs, int count);
+    boolean doLocal2GMT(const double *localEpochs, double *gmtEpochs, int count);
+    int getTransitionCount(void);
+    double getTransition(int k);
+
+  private:
+    float zoneHours = 0.;
+    SiderealDSTRule dstRule = SP_DST_NONE;
+    double tableStart = 0., tableEnd = 0.;  // GMT epochs covered by the table
+    std::vector<double> gmtSwitch;   // Transition instants in time order
+    std::vector<double> localSwitch; // The same, on the local clock just before each switch
+    std::vector<char> dstAfter;      // DST in effect after each transition
+    boolean dstBefore = false;       // DST in effect before the first transition
+
+    boolean calcDST(double gmtEpoch, boolean local);
+};
+
+#endif // SIDEREAL_PLANETS_HOST
+#endif
@@ -0,0 +1,243 @@
+/******************************************************************************
+SiderealVisibility.cpp
+Sidereal Planets nightly visibility window finder C++ source
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+Resources:
+Uses math.h for math functions
+Uses SiderealScheduler to work on several nights at once
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT).
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+// include this library's description file
+#include "SiderealVisibility.h"
+
+#ifdef SIDEREAL_PLANETS_THREADS
+
+static const double OneSecond = 1. / 86400.;      // in days
+static const double SiderealRate = 1.00273790935; // sidereal hours per solar hour
+
+// Hour difference folded into -12 to +12
+static double inRange12(double h) {
+  h = fmod(h, 24.);
+  if (h < -12.) h += 24.;
+  if (h >= 12.) h -= 24.;
+  return h;
+}
+
+// Public Methods //////////////////////////////////////////////////////////
+boolean SiderealVisibility::begin(int workers) {
+  nights = 0;
+  return scheduler.begin(workers);
+}
+
+// Degrees, with elevation in meters
+boolean SiderealVisibility::setSite(double latitude, double longitude, double elevation) {
+  if (latitude < -90. || latitude > 90.) return false; //bad input
+  site.latitude = latitude;
+  site.longitude = longitude;
+  site.elevation = elevation;
+  return true;
+}
+
+// Degrees below the horizon that the Sun must be: 18 is astronomical twilight
+boolean SiderealVisibility::setTwilight(double depression) {
+  if (depression < -90. || depression > 90.) return false; //bad input
+  twilight = depression;
+  return true;
+}
+
+boolean SiderealVisibility::setStepMinutes(double minutes) {
+  if (minutes <= 0. || minutes > 720.) return false; //bad input
+  stepDays = minutes / 1440.;
+  return true;
+}
+
+boolean SiderealVisibility::setTargets(const SiderealTarget *targets, int count) {
+  if (count < 0 || (count > 0 && targets == NULL)) return false; //bad input
+  targetList.assign(targets, targets + count);
+  nights = 0;
+  return true;
+}
+
+// Find the windows for nightCount nights, starting with the night that
+// begins at local mean noon of the given GMT date
+boolean SiderealVisibility::doNights(int year, int month, int day, int nightCount) {
+  if (nightCount < 0) return false;
+  SiderealPlanets astro{};
+  astro.begin();
+  astro.setLatLong(site.latitude, site.longitude);
+  astro.setElevationM(site.elevation);
+  if (astro.setGMTdate(year, month, day) == false) return false;
+  astro.setGMTtime(0, 0, 0.);
+  firstNight = astro.modifiedJulianDate1900() + 0.5 - (site.longitude / 360.);
+  nights = nightCount;
+  darkWindows.assign(nights, std::vector<SiderealWindow>());
+  targetWindows.assign((size_t)nights * targetList.size(), std::vector<SiderealWindow>());
+  scheduler.setPrototype(astro);
+  // Each night writes only its own slots, so nights can run in any order
+  return scheduler.run(nights, [this](SiderealPlanets &worker, long night, int) {
+    doNight(worker, (int)night);
+  }, 1);
+}
+
+int SiderealVisibility::getNightCount(void) {
+  return nights;
+}
+
+double SiderealVisibility::getNightStart(int night) {
+  return firstNight + night;
+}
+
+int SiderealVisibility::getDarkCount(int night) {
+  if (night < 0 || night >= nights) return 0;
+  return (int)darkWindows[night].size();
+}
+
+SiderealWindow SiderealVisibility::getDark(int night, int k) {
+  SiderealWindow none = {0., 0.};
+  if (k < 0 || k >= getDarkCount(night)) return none;
+  return darkWindows[night][k];
+}
+
+int SiderealVisibility::getWindowCount(int night, int target) {
+  if (night < 0 || night >= nights) return 0;
+  if (target < 0 || target >= (int)targetList.size()) return 0;
+  return (int)targetWindows[(size_t)night * targetList.size() + target].size();
+}
+
+SiderealWindow SiderealVisibility::getWindow(int night, int target, int k) {
+  SiderealWindow none = {0., 0.};
+  if (k < 0 || k >= getWindowCount(night, target)) return none;
+  return targetWindows[(size_t)night * targetList.size() + target][k];
+}
+
+// Private Methods /////////////////////////////////////////////////////////
+void SiderealVisibility::doNight(SiderealPlanets &astro, int night) {
+  double start = getNightStart(night);
+  SiderealTarget sun = {SP_SUN, 0., 0., 0.};
+  std::vector<SiderealWindow> &dark = darkWindows[night];
+  findWindows(astro, sun, -twilight, true, start, start + 1., dark);
+  if (dark.empty()) return; //no dark sky tonight
+  std::vector<SiderealWindow> up;
+  for (size_t t = 0; t < targetList.size(); t++) {
+    // Only search the dark part of the night, then clip to each dark window
+    up.clear();
+    findWindows(astro, targetList[t], targetList[t].minAltitude, false, dark.front().start, dark.back().end, up);
+    std::vector<SiderealWindow> &out = targetWindows[(size_t)night * targetList.size() + t];
+    size_t i = 0, j = 0;
+    while (i < up.size() && j < dark.size()) {
+      double s = (up[i].start > dark[j].start) ? up[i].start : dark[j].start;
+      double e = (up[i].end < dark[j].end) ? up[i].end : dark[j].end;
+      if (s < e) out.push_back({s, e});
+      if (up[i].end < dark[j].end) i++; else j++;
+    }
+  }
+}
+
+// Intervals of [start, end] when the target altitude is above the limit
+// (or below it, for the Sun).  Coarse samples, plus any culmination that
+// falls between samples, locate the crossings; calcCrossing() refines them.
+void SiderealVisibility::findWindows(SiderealPlanets &astro, const SiderealTarget &target, double limit, boolean below,
+    double start, double end, std::vector<SiderealWindow> &out) {
+  int n = (int)ceil((end - start) / stepDays);
+  if (n < 2) n = 2;
+  std::vector<double> t(n + 1), f(n + 1);
+  for (int k = 0; k <= n; k++) {
+    t[k] = start + ((end - start) * k) / n;
+    f[k] = calcAltitude(astro, target, t[k]) - limit;
+  }
+  // A window (or gap) can hide between samples at a culmination
+  for (int k = n - 1; k > 0; k--) {
+    boolean peak = (f[k] >= f[k - 1] && f[k] >= f[k + 1]);
+    boolean dip = (f[k] <= f[k - 1] && f[k] <= f[k + 1]);
+    if (peak && f[k] >= 0.) continue;
+    if (dip && f[k] < 0.) continue;
+    if (!peak && !dip) continue;
+    double tc = calcCulmination(astro, target, t[k], peak);
+    if (tc <= t[k - 1] || tc >= t[k + 1] || fabs(tc - t[k]) < OneSecond) continue;
+    double fc = calcAltitude(astro, target, tc) - limit;
+    int at = (tc < t[k]) ? k : k + 1;
+    t.insert(t.begin() + at, tc);
+    f.insert(f.begin() + at, fc);
+  }
+  boolean inside = below ? (f[0] < 0.) : (f[0] >= 0.);
+  double open = start;
+  for (size_t k = 1; k < t.size(); k++) {
+    boolean now = below ? (f[k] < 0.) : (f[k] >= 0.);
+    if (now == inside) continue;
+    double edge = calcCrossing(astro, target, limit, t[k - 1], f[k - 1], t[k], f[k]);
+    if (now) {
+      open = edge;
+    } else {
+      out.push_back({open, edge});
+    }
+    inside = now;
+  }
+  if (inside) out.push_back({open, end});
+}
+
+// Geometric altitude in degrees; leaves the RA/Dec of date in astro
+double SiderealVisibility::calcAltitude(SiderealPlanets &astro, const SiderealTarget &target, double epoch) {
+  astro.setGMTepoch(epoch);
+  if (target.body == SP_FIXED) {
+    astro.setRAdec(target.rightAscension, target.declination);
+  } else {
+    astro.doBody(target.body);
+    if (target.body == SP_MOON) astro.doLunarParallax();
+  }
+  astro.doRAdec2AltAz();
+  return astro.getAltitude();
+}
+
+// Epoch when the altitude crosses the limit between a and b, where fa and fb
+// (altitude - limit) have opposite signs.  As in doRiseSetTimes(), the hour
+// angle at which the current declination reaches the limit gives the next
+// guess.  Guesses outside the bracket fall back to bisection.
+double SiderealVisibility::calcCrossing(SiderealPlanets &astro, const SiderealTarget &target, double limit,
+    double a, double fa, double b, double fb) {
+  boolean rising = (fa < fb);
+  double sinLimit = sin(limit * 1.745329252e-2);
+  double sinLat = sin(site.latitude * 1.745329252e-2);
+  double cosLat = cos(site.latitude * 1.745329252e-2);
+  double t = a + ((b - a) * fa) / (fa - fb);
+  for (int i = 0; i < 30; i++) {
+    double ft = calcAltitude(astro, target, t) - limit;
+    if ((ft >= 0.) == (fa >= 0.)) {
+      a = t;
+      fa = ft;
+    } else {
+      b = t;
+    }
+    double next = 0.5 * (a + b);
+    double dec = astro.getDeclinationDec() * 1.745329252e-2;
+    double cosH = (sinLimit - (sinLat * sin(dec))) / (cosLat * cos(dec));
+    if (cosH >= -1. && cosH <= 1.) {
+      double h = acos(cosH) * 3.819718634; // radians to hours
+      double lst = rising ? astro.getRAdec() - h : astro.getRAdec() + h;
+      double guess = t + inRange12(lst - astro.getLocalSiderealTime()) / (SiderealRate * 24.);
+      if (guess > a && guess < b) next = guess;
+    }
+    if (fabs(next - t) < OneSecond || (b - a) < OneSecond) return next;
+    t = next;
+  }
+  return t;
+}
+
+// Epoch of the upper (or lower) meridian transit nearest the given epoch
+double SiderealVisibility::calcCulmination(SiderealPlanets &astro, const SiderealTarget &target, double epoch, boolean upper) {
+  for (int i = 0; i < 2; i++) {
+    calcAltitude(astro, target, epoch);
+    double ha = astro.getLocalSiderealTime() - astro.getRAdec();
+    if (!upper) ha += 12.;
+    epoch -= inRange12(ha) / (SiderealRate * 24.);
+  }
+  return epoch;
+}
+
+#endif // SIDEREAL_PLANETS_THREADS
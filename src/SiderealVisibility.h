@@ -0,0 +1,94 @@
+/******************************************************************************
+SiderealVisibility.h
+Sidereal Planets nightly visibility window finder Header File
+David Armstrong
+Version 1.6.0 - May 24, 2025
+https://github.com/DavidArmstrong/SiderealPlanets
+
+This file prototypes the SiderealVisibility class, as implemented in SiderealVisibility.cpp
+
+For each night, finds the intervals when each target is above its minimum
+altitude while the Sun is below the twilight depression angle.  A night runs
+from local mean noon to the next local mean noon at the site.
+
+Instead of sampling every minute, the altitude is sampled every 30 minutes
+(setStepMinutes()) and each horizon crossing is refined like doRiseSetTimes():
+the hour angle at which the target reaches the limit altitude gives the next
+guess, which is kept inside the bracketing samples.  Culminations between
+samples are checked, so short windows near the meridian are not missed.
+Window edges are good to about one second of time.
+
+Times are epochs in days since 1900 January 0.5 GMT, the same count as
+modifiedJulianDate1900() + getGMT() / 24 (see setGMTepoch()).
+
+Resources:
+Uses SiderealScheduler to work on several nights at once
+Only built when SIDEREAL_PLANETS_THREADS is defined (the default on the host)
+
+This code is released under the [MIT License](http://opensource.org/licenses/MIT)
+Please review the LICENSE.md file included with this example.
+Distributed as-is; no warranty is given.
+******************************************************************************/
+
+#ifndef __SiderealVisibility_h
+#define __SiderealVisibility_h
+
+#include "SiderealScheduler.h"
+
+#ifdef SIDEREAL_PLANETS_THREADS
+
+#include <vector>
+
+// Something to observe: a SiderealBody number, or SP_FIXED for a star or deep
+// sky object at a fixed RA (hours) and Dec (degrees) of date
+#define SP_FIXED -1
+struct SiderealTarget {
+  int body;
+  double rightAscension;
+  double declination;
+  double minAltitude; // degrees, geometric (no refraction)
+};
+
+// One interval, as epochs (days since 1900 January 0.5 GMT)
+struct SiderealWindow {
+  double start;
+  double end;
+};
+
+class SiderealVisibility {
+  public:
+    boolean begin(int workers = 0);
+    boolean setSite(double latitude, double longitude, double elevation);
+    boolean setTwilight(double depression);
+    boolean setStepMinutes(double minutes);
+    boolean setTargets(const SiderealTarget *targets, int count);
+    boolean doNights(int year, int month, int day, int nightCount);
+    int getNightCount(void);
+    double getNightStart(int night);
+    int getDarkCount(int night);
+    SiderealWindow getDark(int night, int k);
+    int getWindowCount(int night, int target);
+    SiderealWindow getWindow(int night, int target, int k);
+
+  private:
+    SiderealScheduler scheduler;
+    SiderealSite site = {51.178889, -1.826111, 0.};
+    double twilight = 18.;     // Sun depression in degrees
+    double stepDays = 1. / 48.; // coarse sampling step
+    std::vector<SiderealTarget> targetList;
+    double firstNight = 0.;
+    int nights = 0;
+    std::vector<std::vector<SiderealWindow> > darkWindows;   // [night]
+    std::vector<std::vector<SiderealWindow> > targetWindows; // [night * targets + target]
+
+    void doNight(SiderealPlanets &astro, int night);
+    void findWindows(SiderealPlanets &astro, const SiderealTarget &target, double limit, boolean below,
+      double start, double end, std::vector<SiderealWindow> &out);
+    double calcAltitude(SiderealPlanets &astro, const SiderealTarget &target, double epoch);
+    double calcCrossing(SiderealPlanets &astro, const SiderealTarget &target, double limit,
+      double a, double fa, double b, double fb);
+    double calcCulmination(SiderealPlanets &astro, const SiderealTarget &target, double epoch, boolean upper);
+};
+
+#endif // SIDEREAL_PLANETS_THREADS
+#endif